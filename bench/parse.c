@@ -0,0 +1,162 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+/* Benchmark for LC_read() over the workloads in workload.h. */
+
+/* We need clock_gettime(), which isn't part of C99. */
+#define _POSIX_C_SOURCE 200809L
+
+#define LC_REQ_VER 2
+#define LC_REQ_SUBVER 3
+
+#include <libClame.h>
+#include <LC_macros.h>
+
+#include "workload.h"
+
+/* Variables for the flags to write into. */
+typedef struct {
+	bool *bools;
+	int *ints;
+	char **strings;
+	int **arrays;
+	size_t *lengths;
+
+} vars_t;
+
+static LC_flag_t *make_flags(char **lflags, size_t flags, vars_t *vars) {
+	LC_flag_t *table = malloc(flags * sizeof(LC_flag_t));
+	if(!table) abort();
+
+	vars -> bools = calloc(flags, sizeof(bool));
+	vars -> ints = calloc(flags, sizeof(int));
+	vars -> strings = calloc(flags, sizeof(char *));
+	vars -> arrays = calloc(flags, sizeof(int *));
+	vars -> lengths = calloc(flags, sizeof(size_t));
+
+	if(!vars -> bools || !vars -> ints || !vars -> strings
+		|| !vars -> arrays || !vars -> lengths) abort();
+
+	for(size_t i = 0; i < flags; i++) {
+		const char *lflag = &lflags[i][2];
+		char sflag = flag_short(i);
+
+		switch(i % KINDS) {
+		case KIND_BOOL:
+			table[i] = (LC_flag_t) LC_MAKE_BOOL(lflag, sflag,
+				vars -> bools[i], true
+			);
+
+			break;
+
+		case KIND_INT:
+			table[i] = (LC_flag_t) LC_MAKE_VAR(lflag, sflag,
+				vars -> ints[i], "%d"
+			);
+
+			break;
+
+		case KIND_STRING:
+			table[i] = (LC_flag_t) LC_MAKE_STRING(lflag, sflag,
+				vars -> strings[i]
+			);
+
+			break;
+
+		case KIND_ARRAY:
+			table[i] = (LC_flag_t) LC_MAKE_ARR(lflag, sflag,
+				vars -> arrays[i], "%d", vars -> lengths[i]
+			);
+
+			break;
+		}
+	}
+
+	return table;
+}
+
+/* The arrays in the variables belong to the library, which has to release them
+ * with LC_free() while the variables are still around. */
+static void free_flags(LC_flag_t *table, vars_t *vars) {
+	LC_free();
+
+	free(vars -> bools);
+	free(vars -> ints);
+	free(vars -> strings);
+	free(vars -> arrays);
+	free(vars -> lengths);
+	free(table);
+}
+
+static void run(LC_flag_t *table, size_t flags, workload_t *workload,
+	size_t args, mix_t mix)
+{
+	size_t reps = repetitions(args);
+	size_t allocs = 0;
+	double ns = 0;
+
+	for(size_t rep = 0; rep < reps; rep++) {
+		/* LC_read() marks the flags it sees as read-only. */
+		for(size_t i = 0; i < flags; i++) table[i].readonly = false;
+
+		size_t before = allocations;
+		double start = now_ns();
+
+		int ret = LC_read(workload -> argc, workload -> argv);
+
+		ns += now_ns() - start;
+		allocs += allocations - before;
+
+		if(ret != LC_OK) {
+			fprintf(stderr, "parse: error: %s.\n",
+				LC_strerror(ret)
+			);
+			exit(1);
+		}
+	}
+
+	report("LC_read", flags, args, mix, ns, allocs, reps);
+}
+
+int main() {
+	for(size_t i = 0; i < BENCH_LENGTH(flag_counts); i++) {
+		size_t flags = flag_counts[i];
+
+		char **lflags = make_lflags(flags);
+		vars_t vars;
+
+		LC_flags = make_flags(lflags, flags, &vars);
+		LC_flags_length = flags;
+
+		for(size_t j = 0; j < BENCH_LENGTH(arg_counts); j++) {
+			for(mix_t mix = 0; mix < MIXES; mix++) {
+				size_t args = arg_counts[j];
+
+				workload_t workload = make_workload(lflags,
+					flags, args, mix
+				);
+
+				run(LC_flags, flags, &workload, args, mix);
+				free_workload(&workload);
+			}
+		}
+
+		free_flags(LC_flags, &vars);
+		free_lflags(lflags, flags);
+	}
+
+	return 0;
+}
@@ -0,0 +1,144 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+/* Benchmark for libClame::read() over the workloads in workload.h. */
+
+#define LC_REQ_VER 2
+#define LC_REQ_SUBVER 3
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <libClame.hh>
+#include <libClame/generics.hh>
+
+#include "workload.h"
+
+/* Variables for the flags to write into. */
+struct vars_t {
+	explicit vars_t(size_t flags):
+		bools{new bool[flags]{}}, ints(flags), strings(flags),
+		arrays(flags) {}
+
+	std::unique_ptr<bool[]> bools; // std::vector<bool> has no bool&.
+	std::vector<int> ints;
+	std::vector<std::string> strings;
+	std::vector<std::vector<int>> arrays;
+};
+
+static std::vector<LC_flag_t> make_flags(char **lflags, size_t flags,
+	vars_t& vars)
+{
+	std::vector<LC_flag_t> table;
+	table.reserve(flags);
+
+	for(size_t i = 0; i < flags; i++) {
+		std::string lflag = &lflags[i][2];
+		char sflag = flag_short(i);
+
+		switch(i % KINDS) {
+		case KIND_BOOL:
+			table.push_back(libClame::make_bool(
+				lflag, sflag, vars.bools[i], true
+			));
+
+			break;
+
+		case KIND_INT:
+			table.push_back(libClame::make_var(
+				lflag, sflag, vars.ints[i]
+			));
+
+			break;
+
+		case KIND_STRING:
+			table.push_back(libClame::make_string(
+				lflag, sflag, vars.strings[i]
+			));
+
+			break;
+
+		case KIND_ARRAY:
+			table.push_back(libClame::make_arr(
+				lflag, sflag, vars.arrays[i]
+			));
+
+			break;
+		}
+	}
+
+	return table;
+}
+
+static void run(std::vector<LC_flag_t>& table, workload_t& workload,
+	size_t args, mix_t mix)
+{
+	size_t reps = repetitions(args);
+	size_t allocs = 0;
+	double ns = 0;
+
+	for(size_t rep = 0; rep < reps; rep++) {
+		/* The C library marks the flags it sees as read-only, and
+		 * read() adds to the flagless arguments rather than replacing
+		 * them. */
+		for(auto& flag: table) flag.readonly = false;
+		libClame::flagless_args.clear();
+
+		size_t before = allocations;
+		double start = now_ns();
+
+		try {
+			libClame::read(workload.argc, workload.argv, table);
+		}
+
+		catch(libClame::exception& e) {
+			std::fprintf(stderr, "parse: error: %s.\n", e.what());
+			std::exit(1);
+		}
+
+		ns += now_ns() - start;
+		allocs += allocations - before;
+	}
+
+	report("libClame::read", table.size(), args, mix, ns, allocs, reps);
+}
+
+int main() {
+	for(size_t flags: flag_counts) {
+		char **lflags = make_lflags(flags);
+		vars_t vars{flags};
+
+		auto table = make_flags(lflags, flags, vars);
+
+		for(size_t args: arg_counts) {
+			for(int i = 0; i < MIXES; i++) {
+				mix_t mix = (mix_t) i;
+
+				workload_t workload = make_workload(lflags,
+					flags, args, mix
+				);
+
+				run(table, workload, args, mix);
+				free_workload(&workload);
+			}
+		}
+
+		free_lflags(lflags, flags);
+	}
+
+	return 0;
+}
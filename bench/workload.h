@@ -0,0 +1,321 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+/* Synthetic workloads shared by the C and C++ benchmark programs. Both build
+ * the same flag tables and argument lists, so their results can be compared
+ * directly. */
+
+/* Begin Header Guard */
+#ifndef LC_BENCH_WORKLOAD_H
+#define LC_BENCH_WORKLOAD_H 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <sys/resource.h>
+
+/* Count the allocations made by the library by standing in for the allocator.
+ * glibc lets us forward to the real thing through its internal names; other
+ * C libraries just report -1. The C++ operator new goes through malloc() as
+ * well, so this catches everything. */
+#ifdef __GLIBC__
+#ifdef __cplusplus
+#define BENCH_NOEXCEPT noexcept
+extern "C" {
+#else
+#define BENCH_NOEXCEPT
+#endif
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static size_t allocations = 0;
+
+void *malloc(size_t size) BENCH_NOEXCEPT {
+	allocations++;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) BENCH_NOEXCEPT {
+	allocations++;
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) BENCH_NOEXCEPT {
+	allocations++;
+	return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr) BENCH_NOEXCEPT {
+	__libc_free(ptr);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#define BENCH_COUNTS_ALLOCATIONS 1
+#else
+static size_t allocations = 0;
+#define BENCH_COUNTS_ALLOCATIONS 0
+#endif
+
+/* The flags cycle through four kinds, and only the first few have a short
+ * flag. The long flags are named flag0, flag1, and so on. */
+enum {KIND_BOOL, KIND_INT, KIND_STRING, KIND_ARRAY, KINDS};
+
+static const char short_flags[] =
+	"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+#define SHORT_FLAGS (sizeof(short_flags) - 1)
+
+static char flag_short(size_t i) {
+	return i < SHORT_FLAGS? short_flags[i]: 0;
+}
+
+/* How the flags are given on the command line:
+ *
+ * long: --flagN with any values in the following arguments.
+ * short: -c with any values in the following arguments.
+ * bundled: all the boolean short flags in one argument, and values stuck
+ * on to the short flags that take them.
+ * array: a single array flag followed by every remaining argument.
+ *
+ * Whatever's left of the argument list is filled with flagless arguments. */
+typedef enum {MIX_LONG, MIX_SHORT, MIX_BUNDLED, MIX_ARRAY, MIXES} mix_t;
+
+static const char *mix_names[] = {"long", "short", "bundled", "array"};
+
+/* An argument list along with the storage its strings live in. None of the
+ * arguments are ever modified by parsing them, so one list can be parsed
+ * again and again. */
+typedef struct {
+	char **argv;
+	int argc;
+
+	char **lflags; // "--flagN" for each flag.
+	char *bundle;
+
+} workload_t;
+
+static char *bench_strdup(const char *string) {
+	char *copy = (char *) malloc(strlen(string) + 1);
+	if(!copy) abort();
+
+	return strcpy(copy, string);
+}
+
+/* Build the long flag names for a flag table. */
+static char **make_lflags(size_t flags) {
+	char **lflags = (char **) malloc(flags * sizeof(char *));
+	if(!lflags) abort();
+
+	for(size_t i = 0; i < flags; i++) {
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "--flag%zu", i);
+		lflags[i] = bench_strdup(buffer);
+	}
+
+	return lflags;
+}
+
+static void free_lflags(char **lflags, size_t flags) {
+	for(size_t i = 0; i < flags; i++) free(lflags[i]);
+	free(lflags);
+}
+
+static bool push(workload_t *workload, size_t args, const char *arg) {
+	if((size_t) workload -> argc >= args) return false;
+
+	workload -> argv[workload -> argc++] = (char *) arg;
+	return true;
+}
+
+/* Push a flag along with its values, as long as all of it fits. */
+static void push_flag(workload_t *workload, size_t args, size_t i,
+	const char *flag, bool attached)
+{
+	size_t needed = 1;
+
+	switch(i % KINDS) {
+		case KIND_INT: case KIND_STRING: needed = attached? 1: 2; break;
+		case KIND_ARRAY: needed = attached? 3: 4; break;
+	}
+
+	if(workload -> argc + needed > args) return;
+
+	/* Attached values only work for short flags, which are two
+	 * characters long. */
+	static char values[SHORT_FLAGS][16];
+	const char *value = NULL;
+
+	switch(i % KINDS) {
+		case KIND_INT: value = "42"; break;
+		case KIND_STRING: value = "value"; break;
+		case KIND_ARRAY: value = "1"; break;
+	}
+
+	if(attached && value) {
+		snprintf(values[i], sizeof(values[i]), "%s%s", flag, value);
+		push(workload, args, values[i]);
+	}
+
+	else {
+		push(workload, args, flag);
+		if(value) push(workload, args, value);
+	}
+
+	if(i % KINDS == KIND_ARRAY) {
+		push(workload, args, "2");
+		push(workload, args, "--");
+	}
+}
+
+static workload_t make_workload(char **lflags, size_t flags, size_t args,
+	mix_t mix)
+{
+	workload_t workload;
+	workload.argv = (char **) malloc((args + 1) * sizeof(char *));
+	if(!workload.argv) abort();
+
+	workload.argc = 0;
+	workload.lflags = lflags;
+	workload.bundle = NULL;
+
+	push(&workload, args, "bench");
+
+	static char sflags[SHORT_FLAGS][3];
+	size_t shorts = flags < SHORT_FLAGS? flags: SHORT_FLAGS;
+
+	for(size_t i = 0; i < shorts; i++) {
+		sflags[i][0] = '-';
+		sflags[i][1] = short_flags[i];
+		sflags[i][2] = 0;
+	}
+
+	switch(mix) {
+	case MIX_LONG:
+		for(size_t i = 0; i < flags; i++) {
+			push_flag(&workload, args, i, lflags[i], false);
+		}
+
+		break;
+
+	case MIX_SHORT:
+		for(size_t i = 0; i < shorts; i++) {
+			push_flag(&workload, args, i, sflags[i], false);
+		}
+
+		break;
+
+	case MIX_BUNDLED:
+		workload.bundle = (char *) malloc(SHORT_FLAGS + 2);
+		if(!workload.bundle) abort();
+
+		workload.bundle[0] = '-';
+		workload.bundle[1] = 0;
+
+		for(size_t i = 0; i < shorts; i += KINDS) {
+			strncat(workload.bundle, &short_flags[i], 1);
+		}
+
+		push(&workload, args, workload.bundle);
+
+		for(size_t i = 0; i < shorts; i++) {
+			if(i % KINDS == KIND_BOOL) continue;
+			push_flag(&workload, args, i, sflags[i], true);
+		}
+
+		break;
+
+	case MIX_ARRAY:
+		if(flags > KIND_ARRAY) {
+			push(&workload, args, lflags[KIND_ARRAY]);
+			while(push(&workload, args, "7"));
+		}
+
+		break;
+
+	default:
+		break;
+	}
+
+	while(push(&workload, args, "file"));
+
+	workload.argv[workload.argc] = NULL;
+	return workload;
+}
+
+static void free_workload(workload_t *workload) {
+	free(workload -> argv);
+	free(workload -> bundle);
+}
+
+/* Timing and reporting helpers. */
+static double now_ns(void) {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return time.tv_sec * 1e9 + time.tv_nsec;
+}
+
+static long peak_rss_kb(void) {
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+/* Enough repetitions to parse a couple of million arguments in total. */
+static size_t repetitions(size_t args) {
+	size_t reps = (2 << 20) / args;
+	return reps < 3? 3: reps;
+}
+
+/* Report one result as a line of JSON. */
+static void report(const char *api, size_t flags, size_t args, mix_t mix,
+	double ns, size_t allocs, size_t reps)
+{
+	printf("{\"api\": \"%s\", \"flags\": %zu, \"args\": %zu, "
+		"\"mix\": \"%s\", \"ns_per_arg\": %.2f, ", api, flags, args,
+		mix_names[mix], ns / (double) (args * reps)
+	);
+
+	if(BENCH_COUNTS_ALLOCATIONS) {
+		printf("\"allocs_per_parse\": %.2f, ",
+			(double) allocs / (double) reps
+		);
+	}
+
+	else printf("\"allocs_per_parse\": -1, ");
+
+	printf("\"peak_rss_kb\": %ld}\n", peak_rss_kb());
+	fflush(stdout);
+}
+
+/* The sizes we try. */
+static const size_t flag_counts[] = {10, 100, 1000, 10000};
+static const size_t arg_counts[] = {10, 1000, 100000, 1000000};
+
+#define BENCH_LENGTH(array) (sizeof(array) / sizeof(*array))
+
+/* End Header Guard */
+#endif
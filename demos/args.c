@@ -44,7 +44,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#define LC_REQ_VER 1
+#define LC_REQ_VER 2
 #define LC_REQ_SUBVER 1
 
 #include <libClame.h>
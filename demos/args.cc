@@ -46,7 +46,7 @@
 #include <iomanip>
 #include <iostream>
 
-#define LC_REQ_VER 1
+#define LC_REQ_VER 2
 #define LC_REQ_SUBVER 2
 
 #include <libClame.hh>
@@ -23,70 +23,81 @@
 
 /* The LC_flag_t variables are: long_flag, short_flag, function, var_ptr,
  * var_type, value, fmt_string, arr_length, var_length, min_arr_length,
- * max_arr_length, readonly. */
+ * max_arr_length, readonly, context, separator, independent, reserve. The
+ * context is always NULL here; set it on the flag afterwards if the callback
+ * function needs it, and the same goes for independent and reserve. */
 
 /* Flag to call a function. */
 #define LC_MAKE_CALL(lflag, sflag, func) \
-	{lflag, sflag, func, NULL, 0, 0, NULL, NULL, 0, 0, 0, 0}
+	{lflag, sflag, func, NULL, 0, 0, NULL, NULL, 0, 0, 0, 0, NULL, 0, false, \
+		NULL}
 
 /* Flag to set a boolean to a given value. */
 #define LC_MAKE_BOOL(lflag, sflag, var, val) \
 	{lflag, sflag, NULL, &var, LC_BOOL_VAR, val, NULL, NULL, 0, 0, 0, \
-		false}
+		false, NULL, 0, false, NULL}
 
 #define LC_MAKE_BOOL_F(lflag, sflag, var, val, func) \
 	{lflag, sflag, func, &var, LC_BOOL_VAR, val, NULL, NULL, 0, 0, 0, \
-		false}
+		false, NULL, 0, false, NULL}
 
 /* Flags to get config string(s). */
 #define LC_MAKE_STRING(lflag, sflag, var) \
 	{lflag, sflag, NULL, &var, LC_STRING_VAR, 0, NULL, NULL, 0, 0, 0, \
-		false}
+		false, NULL, 0, false, NULL}
 
 #define LC_MAKE_STRING_F(lflag, sflag, var, func) \
 	{lflag, sflag, func, &var, LC_STRING_VAR, 0, NULL, NULL, 0, 0, 0, \
-		false}
+		false, NULL, 0, false, NULL}
 
 #define LC_MAKE_STRING_ARR(lflag, sflag, arr, len) \
 	{lflag, sflag, NULL, &arr, LC_STRING_VAR, 0, NULL, &len, 0, 0, \
-		SIZE_MAX, false}
+		SIZE_MAX, false, NULL, 0, false, NULL}
 
 #define LC_MAKE_STRING_ARR_F(lflag, sflag, arr, len, func) \
 	{lflag, sflag, func, &arr, LC_STRING_VAR, 0, NULL, &len, 0, 0, \
-		SIZE_MAX, false}
+		SIZE_MAX, false, NULL, 0, false, NULL}
+
+#define LC_MAKE_STRING_ARR_SEP(lflag, sflag, arr, len, sep) \
+	{lflag, sflag, NULL, &arr, LC_STRING_VAR, 0, NULL, &len, 0, 0, \
+		SIZE_MAX, false, NULL, sep, false, NULL}
 
 #define LC_MAKE_STRING_ARR_BOUNDED(lflag, sflag, arr, len, min_len, max_len) \
 	{lflag, sflag, NULL, &arr, LC_STRING_VAR, 0, NULL, &len, 0, min_len, \
-		max_len, false}
+		max_len, false, NULL, 0, false, NULL}
 
 #define LC_MAKE_STRING_ARR_BOUNDED_F(lflag, sflag, arr, len, min, max, func) \
 	{lflag, sflag, func, &arr, LC_STRING_VAR, 0, NULL, &len, 0, min, \
-		max, false}
+		max, false, NULL, 0, false, NULL}
 
 /* Flags to get variables or arrays of other types. */
 #define LC_MAKE_VAR(lflag, sflag, var, fmt) \
 	{lflag, sflag, NULL, &var, LC_OTHER_VAR, 0, fmt, NULL, sizeof(var), \
-		0, SIZE_MAX, false}
+		0, SIZE_MAX, false, NULL, 0, false, NULL}
 
 #define LC_MAKE_VAR_F(lflag, sflag, var, fmt, func) \
-	{lflag, sflag, NULL, &var, LC_OTHER_VAR, 0, fmt, NULL, sizeof(var), \
-		0, SIZE_MAX, false}
+	{lflag, sflag, func, &var, LC_OTHER_VAR, 0, fmt, NULL, sizeof(var), \
+		0, SIZE_MAX, false, NULL, 0, false, NULL}
 
 #define LC_MAKE_ARR(lflag, sflag, arr, fmt, len) \
 	{lflag, sflag, NULL, &arr, LC_OTHER_VAR, 0, fmt, &len, sizeof(*arr), \
-		0, SIZE_MAX, false}
+		0, SIZE_MAX, false, NULL, 0, false, NULL}
 
 #define LC_MAKE_ARR_F(lflag, sflag, arr, fmt, len, func) \
 	{lflag, sflag, func, &arr, LC_OTHER_VAR, 0, fmt, &len, sizeof(*arr), \
-		0, SIZE_MAX, false}
+		0, SIZE_MAX, false, NULL, 0, false, NULL}
+
+#define LC_MAKE_ARR_SEP(lflag, sflag, arr, fmt, len, sep) \
+	{lflag, sflag, NULL, &arr, LC_OTHER_VAR, 0, fmt, &len, sizeof(*arr), \
+		0, SIZE_MAX, false, NULL, sep, false, NULL}
 
 #define LC_MAKE_ARR_BOUNDED(lflag, sflag, arr, fmt, len, min_len, max_len) \
 	{lflag, sflag, NULL, &arr, LC_OTHER_VAR, 0, fmt, &len, sizeof(*arr), \
-		min_len, max_len, false}
+		min_len, max_len, false, NULL, 0, false, NULL}
 
 #define LC_MAKE_ARR_BOUNDED_F(lflag, sflag, arr, fmt, len, min, max, func) \
 	{lflag, sflag, func, &arr, LC_OTHER_VAR, 0, fmt, &len, sizeof(*arr), \
-		min, max, false}
+		min, max, false, NULL, 0, false, NULL}
 
 /* End Header Guard */
 #endif
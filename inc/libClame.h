@@ -19,8 +19,8 @@
 #define LIBCLAME_H 1
 
 /* Version Information */
-#define LC_VERSION 1 /* Incremented when backwards compatibility broken. */
-#define LC_SUBVERSION 2 /* Incremented when new features added. */
+#define LC_VERSION 2 /* Incremented when backwards compatibility broken. */
+#define LC_SUBVERSION 3 /* Incremented when new features added. */
 
 /* Check for a bad version number. */
 #ifdef LC_REQ_VER
@@ -82,15 +82,56 @@ typedef struct LC_flag_s {
 	/* Boolean to pevent multiple variable definitions. */
 	bool readonly;
 
+	/* Pointer passed through untouched for the callback function, so that
+	 * it can find its own data without looking the flag up. */
+	void *context;
+
+	/* Character that splits each value of an array flag into several
+	 * elements, as in `--ids=1,2,3', or 0 to keep values whole. */
+	char separator;
+
+	/* Whether the callback function can run alongside other flags'
+	 * callback functions, when they are deferred to the end of the parse
+	 * and run on several threads. */
+	bool independent;
+
+	/* Where an array flag's values go if they aren't to be kept in an
+	 * array of the library's own, as with the C++ containers. It's called
+	 * with the number of values that need room, and returns storage for at
+	 * least that many that still holds the ones written so far, or NULL if
+	 * it can't. The library writes the values straight into it and never
+	 * frees it. */
+	void *(*reserve)(struct LC_flag_s *flag, size_t length);
+
 } LC_flag_t;
 
-/* Flags array and its length. */
+/* Flags array and its length. The long flags are indexed the first time
+ * LC_read() sees a given array, so point LC_flags at a different array (or
+ * change LC_flags_length) if you edit the flag names afterwards. */
 extern LC_flag_t *LC_flags;
 extern size_t LC_flags_length;
 
 /* Command to begin command-line argument processing. */
 extern int LC_read(int argc, char **argv);
 
+/* Read the arguments from a file descriptor, such as the output of `find
+ * -print0', where each one ends with the delimiter (usually '\0' or '\n').
+ * Regular files are mapped into memory, and anything else is read in large
+ * blocks, so no argument is copied or allocated by itself. Since a stream
+ * doesn't have an argv[0], the program name is passed in separately. The
+ * values and flagless arguments point into the mapping or the blocks, which
+ * last until the next parse. Setting LC_flagless_function keeps the memory
+ * bounded, since blocks that nothing points into get reused. This returns
+ * LC_READ_ERR if the descriptor can't be read. */
+extern int LC_read_fd(char *prog_name, int fd, char delimiter);
+
+/* Parse a whole command line held in a single string, splitting it up on
+ * whitespace with quotes and backslashes working the way they do in the shell.
+ * The first word is taken as the program name, like argv[0]. The string is
+ * split up in place, so it must be writable, and the values and flagless
+ * arguments point straight into it. */
+extern int LC_read_string(char *string);
+
 /* Return values for LC_read(). */
 #define LC_OK 0
 #define LC_NO_ARGS 1
@@ -106,11 +147,68 @@ extern int LC_read(int argc, char **argv);
 
 #define LC_BAD_VAR_TYPE 10
 #define LC_NULL_FORMAT_STR 11
+#define LC_DUP_FLAG 12
+#define LC_RESPONSE_ERR 13
+#define LC_READ_ERR 14
+
+/* Maximum nesting depth for GCC-style `@file' response files. Each argument of
+ * the form `@file' is replaced by the whitespace-separated (and optionally
+ * quoted) arguments in that file. Zero, the default, leaves `@' arguments
+ * alone. The arguments point into the mapped file, which stays valid until the
+ * next call to LC_read(). */
+extern size_t LC_response_depth;
+
+/* Array flags that get at least LC_convert_threshold values in a row convert
+ * them on up to LC_convert_threads threads at once, rather than one at a time.
+ * Zero or one thread, the default, keeps everything on the calling thread. The
+ * result is exactly the same either way, including which value ends the array
+ * if one doesn't convert. Arrays with a separator are always converted on the
+ * calling thread. */
+extern size_t LC_convert_threads;
+extern size_t LC_convert_threshold;
+
+/* The arguments are classified and their long flags looked up in a sweep
+ * just ahead of the flags being evaluated, in order, on the calling thread.
+ * Command lines with a huge number of arguments can have all of them swept up
+ * front on up to LC_parse_threads threads instead. Zero or one thread, the
+ * default, keeps the sweep on the calling thread. Only command lines with at
+ * least 65536 arguments are worth splitting up, and the results are exactly
+ * the same either way. */
+extern size_t LC_parse_threads;
 
 /* Set when a flag callback function errors out. */
 extern int (*LC_err_function)();
 extern int LC_function_errno;
 
+/* Set when a parse fails: the index of the argument it stopped at, counting
+ * argv[0] and each argument from a response file, and the flag it was dealing
+ * with, or NULL if there wasn't one. A value that's wrong gives its own index
+ * if it's an argument by itself, and deferred callback functions that fail
+ * give the number of arguments, since they come after all of them. */
+extern size_t LC_err_index;
+extern LC_flag_t *LC_err_flag;
+
+/* Flag callback functions normally run as soon as their flag has been dealt
+ * with. If LC_defer_functions is set, they are queued up instead and run once
+ * the whole command line has been parsed without any errors, still in the
+ * order their flags were given. All of them run even if some of them fail.
+ * The ones for flags marked independent run on up to LC_function_threads
+ * threads at once, alongside the rest, so a callback that waits on a file or
+ * the network doesn't hold up the others. */
+extern bool LC_defer_functions;
+extern size_t LC_function_threads;
+
+/* Every deferred callback function that failed, in the order their flags were
+ * given. LC_err_function and LC_function_errno are set from the first one. */
+typedef struct {
+	LC_flag_t *flag;
+	int function_errno;
+
+} LC_function_error_t;
+
+extern LC_function_error_t *LC_function_errors;
+extern size_t LC_function_errors_length;
+
 /* Get an error string. */
 extern const char *LC_strerror(int error);
 
@@ -118,8 +216,147 @@ extern const char *LC_strerror(int error);
 extern char **LC_flagless_args;
 extern size_t LC_flagless_args_length;
 
+/* If this is set, each flagless argument is passed to it as it is found, along
+ * with the context, instead of being stored in LC_flagless_args. Returning
+ * anything but LC_FUNCTION_OK stops the parse with LC_FUNC_ERR, setting
+ * LC_function_errno and leaving LC_err_function NULL. */
+extern int (*LC_flagless_function)(void *context, char *arg);
+extern void *LC_flagless_context;
+
 /* Program name set via argv[0]. */
 extern char *LC_prog_name;
 
+/* Allocator for the memory that a parse hands back or holds on to: arrays
+ * written to array flags' variables, the flagless arguments array, and the
+ * buffers for split-up strings and response files. realloc() works like the
+ * standard function, allocating when given NULL and returning NULL when it
+ * fails, and free() must accept NULL. If reset() isn't NULL, it's called after
+ * everything has been released, so that an arena can free it all in one go.
+ * Any array that is already in a variable when it is parsed into is reused,
+ * so it has to have come from the same allocator. */
+typedef struct {
+	void *(*realloc)(void *context, void *ptr, size_t size);
+	void (*free)(void *context, void *ptr);
+	void (*reset)(void *context);
+	void *context;
+
+} LC_allocator_t;
+
+/* Switch the allocator behind LC_read() and LC_read_string(), releasing
+ * everything from the last parse first. NULL goes back to malloc(). This
+ * returns LC_OK, or LC_MALLOC_ERR if the global parser can't be set up. */
+extern int LC_set_allocator(const LC_allocator_t *allocator);
+
+/* Release everything from the last call to LC_read() or LC_read_string(). The
+ * arrays in array flags' variables are freed, and the variables are set back
+ * to NULL with a length of zero, so they must still be around. The same goes
+ * for LC_flagless_args. Once a parse has moved on to a different flags array,
+ * the arrays in the old flags' variables are left to the caller instead, so
+ * call this before switching if they should be released, or before freeing
+ * the variables. */
+extern void LC_free(void);
+
+/* A bump allocator, which hands out memory from large blocks and never frees
+ * anything by itself. Releasing a parse that uses it just rewinds the arena,
+ * keeping the most recent block around for the next parse. */
+typedef struct {
+	struct __LC_block_s *blocks;
+	size_t block_size;
+
+} LC_arena_t;
+
+/* Set up an arena whose blocks are at least block_size bytes long, or 64 KiB
+ * if block_size is zero. No memory is allocated until it's needed. */
+extern void LC_arena_init(LC_arena_t *arena, size_t block_size);
+
+/* Get an allocator that uses an arena. */
+extern LC_allocator_t LC_arena_allocator(LC_arena_t *arena);
+
+/* Free everything in an arena at once, or release its blocks entirely. */
+extern void LC_arena_reset(LC_arena_t *arena);
+extern void LC_arena_free(LC_arena_t *arena);
+
+/* Parser context. LC_read() and the variables above share a single parser
+ * between the whole program, but LC_parse() keeps everything in here, so
+ * that separate parsers can run on separate threads at the same time. Flags
+ * are marked as seen in the parser rather than through their readonly field,
+ * so a flags array can even be shared between parsers, as long as its
+ * variables and callback functions can be. */
+typedef struct {
+	/* Flags array and its length, the response file depth and the
+	 * settings for working on several threads. These work the same way as
+	 * LC_flags, LC_flags_length, LC_response_depth, LC_convert_threads,
+	 * LC_convert_threshold and LC_parse_threads. LC_parser_init() sets the
+	 * threshold to the same default as LC_convert_threshold. */
+	LC_flag_t *flags;
+	size_t flags_length;
+	size_t response_depth;
+	size_t convert_threads;
+	size_t convert_threshold;
+	size_t parse_threads;
+
+	/* Work the same way as LC_defer_functions and LC_function_threads. */
+	bool defer_functions;
+	size_t function_threads;
+
+	/* Set by LC_parse(), the same way as the variables above. The
+	 * flagless arguments array belongs to the parser. */
+	char **flagless_args;
+	size_t flagless_args_length;
+	char *prog_name;
+
+	int (*err_function)(LC_flag_t *flag);
+	int function_errno;
+
+	size_t err_index;
+	LC_flag_t *err_flag;
+
+	LC_function_error_t *function_errors;
+	size_t function_errors_length;
+
+	/* Works the same way as LC_flagless_function. */
+	int (*flagless_function)(void *context, char *arg);
+	void *flagless_context;
+
+	/* Internal state, allocated by LC_parser_init(). */
+	struct __LC_state_s *state;
+
+} LC_parser_t;
+
+/* Set up a parser for a flags array, returning LC_OK or LC_MALLOC_ERR. */
+extern int LC_parser_init(LC_parser_t *parser, LC_flag_t *flags,
+	size_t flags_length);
+
+/* Parse the arguments or a string with a parser. These return the same values
+ * as LC_read() and LC_read_string(). */
+extern int LC_parse(LC_parser_t *parser, int argc, char **argv);
+extern int LC_parse_string(LC_parser_t *parser, char *string);
+extern int LC_parse_fd(LC_parser_t *parser, char *prog_name, int fd,
+	char delimiter);
+
+/* Feed a parser its arguments as they arrive instead of all at once. The first
+ * argument fed in is the program name, like argv[0], and each flag is
+ * evaluated as soon as all of its values have arrived, so only a flag that is
+ * still waiting on its values is held on to. LC_finish() deals with whatever
+ * is left over and ends the parse. These return the same values as LC_parse(),
+ * and once something goes wrong, everything fed in afterwards is ignored and
+ * the same error is returned again. The arguments are used in place like argv,
+ * so they have to stay around and be writable. Response files aren't expanded
+ * when feeding arguments in. */
+extern int LC_feed(LC_parser_t *parser, char *arg);
+extern int LC_feed_args(LC_parser_t *parser, size_t count, char **args);
+extern int LC_finish(LC_parser_t *parser);
+
+/* Switch a parser's allocator, and release everything from a parser's last
+ * parse. These work the same way as LC_set_allocator() and LC_free(). */
+extern void LC_parser_set_allocator(LC_parser_t *parser,
+	const LC_allocator_t *allocator);
+
+extern void LC_parser_release(LC_parser_t *parser);
+
+/* Release everything a parser holds on to apart from the arrays in its flags'
+ * variables, which are left to the caller. */
+extern void LC_parser_free(LC_parser_t *parser);
+
 /* End Header Guard */
 #endif
@@ -20,16 +20,29 @@
 
 /* Standard Library Includes. */
 #include <string>
+#include <string_view>
+#include <span>
 
 #include <tuple>
-#include <unordered_map>
 
+#include <deque>
 #include <list>
 #include <vector>
 
 #include <functional>
 #include <exception>
 #include <concepts>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+
+/* std::expected is only in C++23, so we check for it. */
+#include <version>
+
+#ifdef __cpp_lib_expected
+#include <expected>
+#endif
 
 /* Main Program Header. */
 extern "C" {
@@ -39,8 +52,104 @@ extern "C" {
 
 /* Header File Namespace. */
 namespace libClame {
-	/* C++ style callback function definition. */
-	typedef std::function<void()> callback_t;
+	/* C++ style callback function definition. It can hold anything
+	 * callable with no arguments, like a std::function<void()>, and
+	 * anything as big as a std::function is stored inline rather than on
+	 * the heap. Bigger callables are copied to the heap instead. Before
+	 * version 2.3 this was a typedef for std::function<void()>, and it
+	 * can still be made from one. */
+	class callback_t {
+	public:
+		callback_t() noexcept {}
+
+		template<typename F>
+		requires (
+			!std::is_same_v<std::decay_t<F>, callback_t>
+			&& std::is_invocable_v<std::decay_t<F>&>
+		)
+		callback_t(F&& function) {
+			typedef std::decay_t<F> D;
+
+			constexpr bool fits = sizeof(D) <= sizeof(storage)
+				&& alignof(D) <= alignof(std::max_align_t);
+
+			if constexpr(fits) {
+				new(storage) D(std::forward<F>(function));
+
+				invoke = [](void *function) {
+					(*static_cast<D *>(function))();
+				};
+
+				/* Copy src to dest, or destroy src if dest is
+				 * NULL. */
+				manage = [](void *dest, void *src) {
+					D *ptr = static_cast<D *>(src);
+
+					if(dest) new(dest) D(*ptr);
+					else ptr -> ~D();
+				};
+			}
+
+			/* Keep a pointer to a copy on the heap instead. */
+			else {
+				D *ptr = new D(std::forward<F>(function));
+				new(storage) D *(ptr);
+
+				invoke = [](void *function) {
+					(**static_cast<D **>(function))();
+				};
+
+				manage = [](void *dest, void *src) {
+					D *ptr = *static_cast<D **>(src);
+
+					if(dest) new(dest) D *(new D(*ptr));
+					else delete ptr;
+				};
+			}
+		}
+
+		callback_t(const callback_t& other) { copy(other); }
+
+		callback_t& operator=(const callback_t& other) {
+			if(this != &other) {
+				clear();
+				copy(other);
+			}
+
+			return *this;
+		}
+
+		~callback_t() { clear(); }
+
+		/* An empty callback does nothing when it's called. */
+		void operator()() const { if(invoke) invoke(storage); }
+
+	private:
+		void copy(const callback_t& other) {
+			if(!other.invoke) return;
+
+			other.manage(storage, other.storage);
+			invoke = other.invoke;
+			manage = other.manage;
+		}
+
+		void clear() {
+			if(invoke) manage(nullptr, storage);
+			invoke = nullptr;
+		}
+
+		/* Room for four pointers, or a std::function, whichever is
+		 * bigger. */
+		static constexpr size_t storage_size =
+			sizeof(std::function<void()>) > 4 * sizeof(void *)?
+			sizeof(std::function<void()>): 4 * sizeof(void *);
+
+		alignas(std::max_align_t) mutable unsigned char
+			storage[storage_size];
+
+		void (*invoke)(void *function) = nullptr;
+		void (*manage)(void *dest, void *src) = nullptr;
+	};
 
 	/* We can work with std::list, std::forward_list and std::vector for
 	 * arrays of values. */
@@ -105,6 +214,41 @@ namespace libClame {
 		limits_t limits, callback_t function
 	);
 
+	/* Views of config strings. These look straight at the arguments
+	 * rather than copying them, so they stay valid for as long as argv
+	 * does, or until the next parse if they came from a response file.
+	 * A span looks at views that are kept with the flag and reused by
+	 * later parses. */
+	extern LC_flag_t make_string(
+		std::string lflag, char sflag, std::string_view& view
+	);
+
+	extern LC_flag_t make_string(
+		std::string lflag, char sflag, std::string_view& view,
+		callback_t function
+	);
+
+	extern LC_flag_t make_str_arr(
+		std::string lflag, char sflag,
+		std::span<std::string_view>& views
+	);
+
+	extern LC_flag_t make_str_arr(
+		std::string lflag, char sflag,
+		std::span<std::string_view>& views, callback_t function
+	);
+
+	extern LC_flag_t make_str_arr(
+		std::string lflag, char sflag,
+		std::span<std::string_view>& views, limits_t limits
+	);
+
+	extern LC_flag_t make_str_arr(
+		std::string lflag, char sflag,
+		std::span<std::string_view>& views, limits_t limits,
+		callback_t function
+	);
+
 	/* Command to begin command-line argument processing. */
 	extern void read(int argc, char** argv, std::vector<LC_flag_t>& flags);
 
@@ -117,23 +261,223 @@ namespace libClame {
 		int error;
 	};
 
-	/* Non-flag variables encountered during processing. */
+	/* What try_read() gives back when the parse works: the flagless
+	 * arguments, pointing into argv, and the program name. */
+	struct result {
+		std::span<char *> flagless_args;
+		const char *prog_name;
+	};
+
+	/* And what it gives back when it doesn't: the code that read() would
+	 * have thrown, along with the index of the argument the parse stopped
+	 * at and the flag it was dealing with, in the same way as LC_err_index
+	 * and LC_err_flag. */
+	struct error {
+		int code;
+		size_t index;
+		const LC_flag_t *flag;
+
+		const char *what() const noexcept { return LC_strerror(code); }
+	};
+
+	/* std::expected if the standard library has it, or just enough of it
+	 * for try_read() otherwise. */
+	#ifdef __cpp_lib_expected
+	template<typename T, typename E>
+	using expected = std::expected<T, E>;
+
+	template<typename E>
+	using unexpected = std::unexpected<E>;
+	#else
+	template<typename E>
+	class unexpected {
+	public:
+		constexpr explicit unexpected(E error): value{error} {}
+		constexpr const E& error() const noexcept { return value; }
+
+	private:
+		E value;
+	};
+
+	template<typename T, typename E>
+	class expected {
+	public:
+		constexpr expected(T value): ok{true}, val{value}, err{} {}
+
+		constexpr expected(unexpected<E> error):
+			ok{false}, val{}, err{error.error()} {}
+
+		constexpr bool has_value() const noexcept { return ok; }
+		constexpr explicit operator bool() const noexcept { return ok; }
+
+		constexpr const T& operator*() const noexcept { return val; }
+		constexpr const T *operator->() const noexcept { return &val; }
+		constexpr const E& error() const noexcept { return err; }
+
+	private:
+		bool ok;
+		T val;
+		E err;
+	};
+	#endif
+
+	/* Parse the arguments like read(), but give back what went wrong
+	 * instead of throwing it. The flagless arguments and program name
+	 * aren't copied into the variables below, so nothing is allocated
+	 * here after the first call. */
+	extern expected<result, error> try_read(
+		int argc, char **argv, std::vector<LC_flag_t>& flags
+	) noexcept;
+
+	/* Non-flag variables encountered during processing. Each call to
+	 * read() adds to the ones already here. */
 	extern std::vector<std::string> flagless_args;
 
 	/* Program name set via argv[0]. */
 	extern std::string prog_name;
 
-	/* Tables for C/C++ interop and C++ lambda cache tables. */
-	extern std::list<std::string> __string_list;
-	extern std::unordered_map<std::string, callback_t> __call_table;
-	extern std::unordered_map<std::string, callback_t> __shadow_table;
-	extern std::unordered_map<std::string, char*> __c_string_table;
+	/* read() copies the flagless arguments and the program name into the
+	 * strings above. Setting this to false skips the copies, leaving
+	 * flagless_view() and LC_prog_name to get at them instead. */
+	extern bool copy_args;
+
+	/* The flagless arguments from the last parse, pointing into argv. */
+	extern std::span<char *> flagless_view();
+
+	/* Every flag made here gets an entry, which its context points to.
+	 * The C library writes values to c_value and c_length, and commit()
+	 * then moves them over to the C++ variable before the callback runs.
+	 * Arrays are written through the flag's reserve() function, straight
+	 * into the storage of a staging vector that's swapped with the
+	 * variable or else into the scratch space here, and a span of strings
+	 * also keeps the views it looks at here. */
+	struct __entry_t {
+		void *var;
+		void *c_value;
+		size_t c_length;
+
+		void (*commit)(__entry_t *entry);
+		callback_t function;
+
+		std::shared_ptr<void> staging;
+		std::vector<std::max_align_t> scratch;
+		std::vector<std::string_view> views;
+
+		size_t id;
+		const void *owner;
+	};
+
+	/* Room for size bytes in an entry's scratch space, keeping what's
+	 * already there, or NULL if it can't be had. */
+	extern void *__scratch(__entry_t *entry, size_t size) noexcept;
 
-	extern std::unordered_map<std::string, std::tuple<char**, size_t>>
-		__c_strarr_table;
+	template<typename T>
+	void *__reserve_scratch(LC_flag_t *flag, size_t length) noexcept {
+		auto entry = (__entry_t *) flag -> context;
+		return __scratch(entry, length * sizeof(T));
+	}
+
+	/* Storage for C/C++ interop. The entries are kept in large chunks,
+	 * so that they never move and making a flag doesn't usually need an
+	 * allocation, and each one's ID is its index in the table. The IDs
+	 * of the entries that parsers have finished with are kept for new
+	 * flags to reuse. The table is shared by every parser, so it's
+	 * locked while it's being changed, and flags can be made on several
+	 * threads at once.
+	 *
+	 * An entry belongs to the first parser its flag is added to, or to
+	 * read() if that uses it first, and it can't be claimed by anything
+	 * else after that. Only its owner can release it. */
+	class __table_t {
+	public:
+		__entry_t *make();
+		bool claim(size_t id, const void *owner);
+		void release(size_t id, const void *owner);
+		size_t size() const;
+
+	private:
+		__entry_t& operator[](size_t id) {
+			return chunks[id / chunk_size][id % chunk_size];
+		}
+
+		static constexpr size_t chunk_size = 256;
+
+		std::vector<std::unique_ptr<__entry_t[]>> chunks;
+		size_t length = 0;
+		std::vector<size_t> free;
+
+		mutable std::mutex lock;
+	};
+
+	/* The table is made on first use, so that flags can be made before
+	 * main(), even from other translation units. */
+	extern __table_t& __entries();
+
+	/* Make an entry for a flag. */
+	extern __entry_t *__make_entry(
+		void *var, void (*commit)(__entry_t *entry),
+		callback_t function
+	);
+
+	/* The long flags and format strings are interned: each distinct
+	 * string is copied once into a large block and handed out from there
+	 * every time after that. An empty long flag means that the flag
+	 * doesn't have one, and gives NULL. This is safe to call from
+	 * several threads at once. */
+	extern const char *__intern(std::string_view string);
+	extern const char *__make_lflag(std::string& lflag);
 
 	/* Function call interceptor. */
 	extern int __interceptor(LC_flag_t* __c_flag);
+
+	/* A parser with its own flags, for parsing many command lines one
+	 * after another without going through the globals above. The entries
+	 * of the flags added to it are released with the parser, and their
+	 * IDs go back to the table for new flags to reuse. */
+	class parser {
+	public:
+		parser();
+		~parser();
+
+		parser(const parser&) = delete;
+		parser& operator=(const parser&) = delete;
+
+		/* Add a flag made by one of the functions above. The flag
+		 * then belongs to this parser, so adding it to a second parser
+		 * or using it with read() throws or gives back LC_DUP_FLAG. */
+		void add(LC_flag_t flag);
+
+		/* Parse the arguments, throwing libClame::exception on
+		 * failure. Values are committed to the variables in the same
+		 * way as read(). */
+		void read(int argc, char **argv);
+
+		/* Or give back what went wrong instead, like try_read(). */
+		expected<result, error> try_read(
+			int argc, char **argv
+		) noexcept;
+
+		/* Forget the results of the last parse. Every flag can be set
+		 * again by the next parse whether or not this is called, and
+		 * nothing is freed either way, so a parser that has already
+		 * seen a command line as long as the next one doesn't need to
+		 * allocate anything more. */
+		void reset();
+
+		/* The flagless arguments from the last parse, pointing into
+		 * the argv that was parsed, and the program name. */
+		std::span<char *> flagless_args() const;
+		const char *prog_name() const;
+
+		/* The C parser underneath, for settings like the response file
+		 * depth and the thread counts. */
+		LC_parser_t& c_parser();
+
+	private:
+		std::vector<LC_flag_t> flags;
+		std::vector<size_t> entries;
+		LC_parser_t c;
+	};
 };
 
 /* End Header Guard */
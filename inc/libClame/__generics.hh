@@ -43,10 +43,6 @@ constexpr std::string_view __get_fmt() {
 	return ""; // The user must specify a custom format.
 }
 
-/* Tables for C/C++ interop. */
-template<typename T>
-std::unordered_map<std::string, std::tuple<T*, size_t>> __c_arr_table;
-
 /* Flags to get variables of various types. */
 
 /* We'll use a helper function that takes all possible arguments, and call it
@@ -56,24 +52,21 @@ LC_flag_t __make_var(
 	std::string lflag, char sflag, T& var, std::string sscanf_fmt,
 	callback_t function
 ){
-	/* Copy the flag since lflag is invalid after function scope. */
-	__string_list.push_back(std::move(lflag));
-	const auto& c_lflag = (
-		*__string_list.rbegin()
-	).c_str();
-
-	/* Run the callback code. */
-	__call_table[c_lflag] = function;
-
-	/* Get the format string and store it away. */
-	__string_list.push_back(sscanf_fmt);
+	/* The C code writes straight to the variable, so there's nothing to
+	 * do before the callback runs. */
+	const auto c_lflag = __make_lflag(lflag);
+	auto entry = __make_entry(&var, NULL, function);
 
-	auto fmt = (*__string_list.rbegin()).c_str();
+	/* Get the format string from the interned ones. */
+	auto fmt = __intern(sscanf_fmt);
 
 	/* Make the structure. */
-	return LC_MAKE_VAR_F(
+	LC_flag_t flag = LC_MAKE_VAR_F(
 		c_lflag, sflag, var, fmt, __interceptor
 	);
+
+	flag.context = entry;
+	return flag;
 }
 
 /* Overloaded interface functions. */
@@ -83,8 +76,8 @@ LC_flag_t make_var(std::string lflag, char sflag, T& var) {
 	constexpr auto fmt = __get_fmt<T>();
 	static_assert(!fmt.empty(), "Type requires explicit format string.");
 
-	/* Pass in a dummy lambda that does nothing. */
-	return __make_var(lflag, sflag, var, std::string{fmt}, [](){});
+	/* Pass in an empty callback that does nothing. */
+	return __make_var(lflag, sflag, var, std::string{fmt}, {});
 }
 
 template<typename T>
@@ -102,8 +95,8 @@ template<typename T>
 LC_flag_t make_var(
 	std::string lflag, char sflag, T& var, std::string sscanf_fmt
 ){
-	/* Pass in a dummy lambda that does nothing. */
-	return __make_var(lflag, sflag, var, sscanf_fmt, [](){});
+	/* Pass in an empty callback that does nothing. */
+	return __make_var(lflag, sflag, var, sscanf_fmt, {});
 }
 
 template<typename T>
@@ -116,70 +109,89 @@ LC_flag_t make_var(
 
 /* Flags to get arrays of various types. */
 
-/* We'll use a helper function that takes all possible arguments, and call it
- * through each of the overloaded interface functions we need to make. */
+/* Vectors, other than the packed vector<bool>, have storage of their own
+ * that the C code can convert the values straight into. The values go into a
+ * vector kept in the entry, which is only swapped with the variable once the
+ * flag's values have all been read, so a parse that fails part of the way
+ * through leaves the variable as it was. */
 template<template<typename> typename C, typename T>
-requires ok_container<C, T>
-LC_flag_t __make_arr(
-	std::string& lflag, char sflag, C<T>* arr_ptr, limits_t limits,
-	std::string sscanf_fmt, callback_t function
-){
-	/* Copy the flag since lflag is invalid after function scope. */
-	__string_list.push_back(std::move(lflag));
-	const auto c_lflag = (*__string_list.rbegin()).c_str();
-
-	/* Pointer to malloc()'d C arr we'll manage. */
-	auto& c_arr_entry = __c_arr_table<T>[c_lflag] = {NULL, 0};
-	auto& c_arr = std::get<0>(c_arr_entry);
-	auto& c_arr_len = std::get<1>(c_arr_entry);
-
-	/* Add the function to our shadow table. Empty lambda if nothing was
-	 * provided in the optional. */
-	__shadow_table[c_lflag] = function;
-
-	/* Add our lambda function  */
-	__call_table[c_lflag] = [c_lflag, arr_ptr](){
-		/* Dereference the pointer to get a C++ reference. */
-		auto& arr = *arr_ptr;
-
-		/* Pointer to malloc()'d C arr we'll manage. */
-		auto& c_arr_entry = __c_arr_table<T>[c_lflag];
-		auto& c_arr = std::get<0>(c_arr_entry);
-		auto& c_arr_len = std::get<1>(c_arr_entry);
+constexpr bool __in_place = (
+	std::is_same_v<C<T>, std::vector<T>> && !std::is_same_v<T, bool>
+);
 
-		/* Get the reference to the function we were provided. */
-		const auto& function = __shadow_table[c_lflag];
+template<typename T>
+void *__reserve_vector(LC_flag_t *flag, size_t length) noexcept {
+	auto entry = (__entry_t *) flag -> context;
+	auto& arr = *(std::vector<T> *) entry -> staging.get();
 
-		/* Clear the C++ array. */
-		arr.clear();
-		arr.resize(c_arr_len);
+	/* Any room the vector already has is reused, so a later parse of as
+	 * many values doesn't need to allocate anything. */
+	try { if(arr.size() < length) arr.resize(length); }
+	catch(...) { return NULL; }
 
-		/* Copy the values over. */
-		size_t i1 = 0;
-		for(auto& i2: arr) i2 = c_arr[i1++];
+	return arr.data();
+}
 
-		/* Free the array. */
-		std::free(c_arr);
-		c_arr = NULL;
+template<template<typename> typename C, typename T>
+requires ok_container<C, T>
+void __commit_arr(__entry_t *entry) {
+	auto& arr = *(C<T> *) entry -> var;
+
+	/* The values are already in place, so the vector only needs cutting
+	 * down to the ones the parse found before it's swapped in. The old
+	 * one's storage is kept for the next parse. */
+	if constexpr(__in_place<C, T>) {
+		auto& staging = *(std::vector<T> *) entry -> staging.get();
+
+		staging.resize(entry -> c_length);
+		arr.swap(staging);
+	}
+
+	/* Anything else gets them from the entry's scratch space. */
+	else {
+		auto c_arr = *(T **) &entry -> c_value;
+		arr.assign(c_arr, c_arr + entry -> c_length);
+	}
+}
 
-		/* Run the callback code if it was specified. */
-		function();
-	};
+template<template<typename> typename C, typename T>
+requires ok_container<C, T>
+LC_flag_t __make_arr(
+	std::string& lflag, char sflag, C<T>* arr_ptr, limits_t limits,
+	std::string sscanf_fmt, callback_t function
+){
+	const auto c_lflag = __make_lflag(lflag);
+	auto entry = __make_entry(arr_ptr, __commit_arr<C, T>, function);
 
-	/* Get the format string and store it away. */
-	__string_list.push_back(sscanf_fmt);
+	/* The C code writes where the values went, whether that's the
+	 * staging vector's storage or the entry's scratch space, and how many
+	 * there are to the entry. */
+	auto& c_arr = *(T **) &entry -> c_value;
+	auto& c_arr_len = entry -> c_length;
 
-	auto fmt = (*__string_list.rbegin()).c_str();
+	/* Get the format string from the interned ones. */
+	auto fmt = __intern(sscanf_fmt);
 
 	/* Get the limits for the array as they are defined. */
 	const auto& min = std::get<0>(limits);
 	const auto& max = std::get<1>(limits);
 
 	/* Make the structure. */
-	return LC_MAKE_ARR_BOUNDED_F(
+	LC_flag_t flag = LC_MAKE_ARR_BOUNDED_F(
 		c_lflag, sflag, c_arr, fmt, c_arr_len, min, max,
 		__interceptor
 	);
+
+	flag.context = entry;
+
+	if constexpr(__in_place<C, T>) {
+		entry -> staging = std::make_shared<std::vector<T>>();
+		flag.reserve = __reserve_vector<T>;
+	}
+
+	else flag.reserve = __reserve_scratch<T>;
+
+	return flag;
 }
 
 template<template<typename> typename C, typename T>
@@ -191,10 +203,10 @@ LC_flag_t make_arr(
 	constexpr auto fmt = __get_fmt<T>();
 	static_assert(!fmt.empty(), "Type requires explicit format string.");
 
-	/* Pass in a dummy lambda that does nothing. Set the size limits to
+	/* Pass in an empty callback that does nothing. Set the size limits to
 	 * accept any length of array. */
 	return __make_arr(
-		lflag, sflag, &arr, {0, SIZE_MAX}, std::string{fmt}, [](){}
+		lflag, sflag, &arr, {0, SIZE_MAX}, std::string{fmt}, {}
 	);
 }
 
@@ -222,8 +234,8 @@ LC_flag_t make_arr(
 	constexpr auto fmt = __get_fmt<T>();
 	static_assert(!fmt.empty(), "Type requires explicit format string.");
 
-	/* Pass in a dummy lambda that does nothing. */
-	return __make_arr(lflag, sflag, &arr, limits, std::string{fmt}, [](){});
+	/* Pass in an empty callback that does nothing. */
+	return __make_arr(lflag, sflag, &arr, limits, std::string{fmt}, {});
 }
 
 template<template<typename> typename C, typename T>
@@ -246,10 +258,10 @@ requires ok_container<C, T>
 LC_flag_t make_arr(
 	std::string lflag, char sflag, C<T>& arr, std::string sscanf_fmt
 ){
-	/* Pass in a dummy lambda that does nothing. Set the size limits to
+	/* Pass in an empty callback that does nothing. Set the size limits to
 	 * accept any length of array. */
 	return __make_arr(
-		lflag, sflag, &arr, {0, SIZE_MAX}, sscanf_fmt, [](){}
+		lflag, sflag, &arr, {0, SIZE_MAX}, sscanf_fmt, {}
 	);
 }
 
@@ -271,8 +283,8 @@ LC_flag_t make_arr(
 	std::string lflag, char sflag, C<T>& arr, limits_t limits,
 	std::string sscanf_fmt
 ){
-	/* Pass in a dummy lambda that does nothing. */
-	return __make_arr(lflag, sflag, &arr, limits, sscanf_fmt, [](){});
+	/* Pass in an empty callback that does nothing. */
+	return __make_arr(lflag, sflag, &arr, limits, sscanf_fmt, {});
 }
 
 template<template<typename> typename C, typename T>
@@ -0,0 +1,132 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+/* Begin Header Guard. */
+#ifndef LC_GENERATOR_HH
+#define LC_GENERATOR_HH 1
+
+/* Standard Library Includes. */
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <utility>
+
+/* Header File Namespace. */
+namespace libClame {
+	/* A lazily evaluated sequence of values, produced by a coroutine that
+	 * co_yields them one at a time. The coroutine only runs as far as the
+	 * next value each time the iterator is advanced, and any exception it
+	 * throws comes out of begin() or operator++. This is the bare minimum
+	 * needed until std::generator from C++23 is available. */
+	template<typename T>
+	class generator {
+	public:
+		struct promise_type {
+			T value;
+			std::exception_ptr exception;
+
+			generator get_return_object() {
+				return generator{handle_t::from_promise(*this)};
+			}
+
+			std::suspend_always initial_suspend() noexcept {
+				return {};
+			}
+
+			std::suspend_always final_suspend() noexcept {
+				return {};
+			}
+
+			std::suspend_always yield_value(T next) {
+				value = std::move(next);
+				return {};
+			}
+
+			void return_void() noexcept {}
+
+			void unhandled_exception() {
+				exception = std::current_exception();
+			}
+		};
+
+		typedef std::coroutine_handle<promise_type> handle_t;
+
+		class iterator {
+		public:
+			typedef std::ptrdiff_t difference_type;
+			typedef T value_type;
+
+			iterator() = default;
+			explicit iterator(handle_t handle): handle{handle} {}
+
+			const T& operator*() const {
+				return handle.promise().value;
+			}
+
+			iterator& operator++() {
+				resume(handle);
+				return *this;
+			}
+
+			void operator++(int) { ++*this; }
+
+			bool operator==(std::default_sentinel_t) const {
+				return !handle || handle.done();
+			}
+
+		private:
+			handle_t handle = nullptr;
+		};
+
+		generator(generator&& other) noexcept:
+			handle{std::exchange(other.handle, nullptr)} {}
+
+		generator& operator=(generator&& other) noexcept {
+			std::swap(handle, other.handle);
+			return *this;
+		}
+
+		~generator() { if(handle) handle.destroy(); }
+
+		/* Start the coroutine running. This can only be done once. */
+		iterator begin() {
+			resume(handle);
+			return iterator{handle};
+		}
+
+		std::default_sentinel_t end() const { return {}; }
+
+	private:
+		explicit generator(handle_t handle): handle{handle} {}
+
+		/* Run the coroutine up to its next value, passing on anything
+		 * that it throws. */
+		static void resume(handle_t handle) {
+			handle.resume();
+
+			auto& exception = handle.promise().exception;
+			if(!exception) return;
+
+			auto caught = std::exchange(exception, nullptr);
+			std::rethrow_exception(caught);
+		}
+
+		handle_t handle;
+	};
+};
+
+/* End Header Guard */
+#endif
@@ -0,0 +1,810 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+/* Begin Header Guard. */
+#ifndef LC_SCHEMA_HH
+#define LC_SCHEMA_HH 1
+
+/* Standard Library Includes. */
+#include <array>
+#include <bit>
+#include <bitset>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/* Main Header File. */
+#include <libClame.hh>
+#include <libClame/generator.hh>
+
+/* Header File Namespace. */
+namespace libClame {
+	/* A string literal that can be passed as a template argument. */
+	template<size_t N>
+	struct fixed_string {
+		constexpr fixed_string(const char (&string)[N]) {
+			for(size_t i = 0; i < N; i++) data[i] = string[i];
+		}
+
+		constexpr std::string_view view() const {
+			return {data, N - 1};
+		}
+
+		char data[N];
+	};
+
+	/* A flag in a schema. An empty long flag or a short flag of zero means
+	 * that the flag doesn't have one. The type decides what the flag does:
+	 *
+	 * void: calls a void (*)() function.
+	 * bool: sets a bool to true.
+	 * arithmetic types: converts a single value.
+	 * std::string, std::string_view, char *: stores a single string.
+	 * std::vector<T> of any of the above: collects an array of values,
+	 * which must have between min and max elements. */
+	template<
+		fixed_string lflag, char sflag, typename T,
+		size_t min = 0, size_t max = SIZE_MAX
+	>
+	struct flag {
+		typedef T type;
+
+		static constexpr std::string_view long_flag = lflag.view();
+		static constexpr char short_flag = sflag;
+		static constexpr size_t min_length = min, max_length = max;
+
+		/* What the schema is constructed with for this flag. */
+		typedef std::conditional_t<std::is_void_v<T>,
+			void (*)(), std::add_lvalue_reference_t<T>
+		> binding_t;
+	};
+
+	/* Type-specific helpers for the schema. */
+	template<typename T>
+	struct __is_vector : std::false_type {};
+
+	template<typename T>
+	struct __is_vector<std::vector<T>> : std::true_type {};
+
+	template<typename T>
+	concept __schema_value = (
+		std::is_arithmetic_v<T> && !std::is_same_v<T, bool>
+	) || (
+		std::is_same_v<T, std::string>
+		|| std::is_same_v<T, std::string_view>
+		|| std::is_same_v<T, const char *>
+		|| std::is_same_v<T, char *>
+	);
+
+	template<typename T>
+	concept __schema_type = (
+		std::is_void_v<T> || std::is_same_v<T, bool>
+		|| __schema_value<T>
+	);
+
+	template<typename T>
+	concept __schema_array = (
+		__is_vector<T>::value && __schema_value<typename T::value_type>
+	);
+
+	/* Convert a whole value into a variable, returning false if it isn't
+	 * valid. Numbers go through std::from_chars(), which doesn't depend on
+	 * the locale and reports values that don't fit the variable. */
+	template<typename T>
+	bool __schema_convert(char *value, T& dest) {
+		if constexpr(std::is_same_v<T, char>) {
+			if(!value[0] || value[1]) return false;
+			dest = value[0];
+			return true;
+		}
+
+		else if constexpr(std::is_arithmetic_v<T>) {
+			const char *end = value + std::strlen(value);
+
+			/* Like sscanf(), allow an explicit plus sign. */
+			if(value[0] == '+' && value[1] != '-') value++;
+
+			auto [ptr, ec] = std::from_chars(value, end, dest);
+			return ec == std::errc() && ptr == end && ptr != value;
+		}
+
+		else {
+			dest = value;
+			return true;
+		}
+	}
+
+	/* 64-bit FNV-1a, the same as the C library uses for its index. */
+	constexpr uint64_t __schema_hash(std::string_view string) {
+		uint64_t hash = UINT64_C(14695981039346656037);
+
+		for(char ch: string) {
+			hash ^= (unsigned char) ch;
+			hash *= UINT64_C(1099511628211);
+		}
+
+		return hash;
+	}
+
+	/* What libClame::events() hands back for each part of the command
+	 * line. A flag is followed by an event for each of its values, and the
+	 * index is the position of the flag in the schema. Flagless arguments
+	 * are positional, and their index is the size of the schema. The text
+	 * points straight into argv: the name of a flag as it was given (less
+	 * the hyphens), or the whole of a value or positional argument. */
+	enum class event_kind { flag, value, positional };
+
+	struct event {
+		event_kind kind;
+		size_t index;
+		std::string_view text;
+	};
+
+	/* A parser generated from a set of flags. The lookup tables for the
+	 * flags are built at compile time, and each flag gets its own inlined
+	 * code to convert and store its values, so parsing does no allocation
+	 * beyond what std::string and std::vector variables need, and the list
+	 * of flagless arguments, which is kept between parses. */
+	template<typename... Flags>
+	class schema {
+	public:
+		static constexpr size_t size = sizeof...(Flags);
+
+		/* Bind each flag, in order, to its variable or function. */
+		explicit schema(typename Flags::binding_t... vars):
+			bindings{vars...} {}
+
+		/* Parse the arguments, throwing libClame::exception on
+		 * failure. argv itself is left in the order it was given. */
+		void read(int argc, char **argv) {
+			int ret = parse(argc, argv);
+			if(ret != LC_OK) throw exception(ret);
+		}
+
+		/* Parse the arguments, returning an LC_* error code. */
+		int parse(int argc, char **argv);
+
+		/* The flagless arguments from the last parse. These point into
+		 * the argv that was parsed. */
+		std::span<char * const> flagless_args() const {
+			return flagless;
+		}
+
+		/* Program name set via argv[0]. */
+		const char *prog_name() const { return args[0]; }
+
+		/* Walk the arguments lazily, yielding an event for each flag,
+		 * value and flagless argument as the loop gets to it, instead
+		 * of storing anything. Values are checked the same way that
+		 * parse() checks them, and problems are reported by throwing a
+		 * libClame::exception as the loop gets to them. Nothing in argv
+		 * is changed, and the variables bound to the schema are left
+		 * alone. A schema can only walk one set of arguments at a time,
+		 * whether it's doing so through parse() or events(). */
+		generator<event> events(int argc, char **argv);
+
+	private:
+		/* Compile-time lookup tables. */
+		static constexpr std::array<std::string_view, size> lflags = {
+			Flags::long_flag...
+		};
+
+		static constexpr std::array<char, size> sflags = {
+			Flags::short_flag...
+		};
+
+		static constexpr bool unique() {
+			for(size_t i = 0; i < size; i++) {
+				for(size_t j = i + 1; j < size; j++) {
+					auto lflag = lflags[i];
+					char sflag = sflags[i];
+
+					if(lflag.size() && lflag == lflags[j]) {
+						return false;
+					}
+
+					if(sflag && sflag == sflags[j]) {
+						return false;
+					}
+				}
+			}
+
+			return true;
+		}
+
+		static_assert(unique(), "schema has duplicate flags");
+
+		static_assert(
+			((__schema_type<typename Flags::type> || __schema_array<
+				typename Flags::type>) && ...),
+			"schema has flags of an unsupported type"
+		);
+
+		/* Open-addressing hash table of long flags, kept at most half
+		 * full. Each slot holds the index of the flag plus one, or zero
+		 * if it's empty. */
+		static constexpr size_t capacity = std::bit_ceil(size * 2 + 1);
+
+		static constexpr std::array<uint16_t, capacity> slots = [] {
+			std::array<uint16_t, capacity> slots{};
+
+			for(size_t i = 0; i < size; i++) {
+				if(!lflags[i].size()) continue;
+
+				size_t slot = __schema_hash(lflags[i]);
+				slot %= capacity;
+
+				while(slots[slot]) slot = (slot + 1) % capacity;
+				slots[slot] = i + 1;
+			}
+
+			return slots;
+		}();
+
+		/* Short flag dispatch table, indexed the same way. */
+		static constexpr std::array<uint16_t, 256> sflag_slots = [] {
+			std::array<uint16_t, 256> slots{};
+
+			for(size_t i = 0; i < size; i++) {
+				unsigned char sflag = sflags[i];
+				if(sflag) slots[sflag] = i + 1;
+			}
+
+			return slots;
+		}();
+
+		static_assert(size < UINT16_MAX, "schema has too many flags");
+
+		static size_t find_lflag(std::string_view lflag) {
+			size_t slot = __schema_hash(lflag) % capacity;
+
+			for(; slots[slot]; slot = (slot + 1) % capacity) {
+				size_t i = slots[slot] - 1;
+				if(lflags[i] == lflag) return i;
+			}
+
+			return size;
+		}
+
+		static size_t find_sflag(char sflag) {
+			return sflag_slots[(unsigned char) sflag] - 1;
+		}
+
+		/* Whether each flag takes a value from the command line, and
+		 * whether it takes an array of them. */
+		static constexpr std::array<bool, size> takes_value = {(
+			!std::is_void_v<typename Flags::type>
+			&& !std::is_same_v<typename Flags::type, bool>
+		)...};
+
+		static constexpr std::array<bool, size> takes_array = {
+			__is_vector<typename Flags::type>::value...
+		};
+
+		static constexpr std::array<size_t, size> min_lengths = {
+			Flags::min_length...
+		};
+
+		static constexpr std::array<size_t, size> max_lengths = {
+			Flags::max_length...
+		};
+
+		/* Jump table to the code for the flag at each index. */
+		template<size_t... I>
+		static constexpr auto make_dispatch(std::index_sequence<I...>) {
+			return std::array<int (schema::*)(char *), size>{
+				&schema::evaluate<I>...
+			};
+		}
+
+		int dispatch(size_t i, char *value) {
+			static constexpr auto table = make_dispatch(
+				std::index_sequence_for<Flags...>()
+			);
+
+			return (this ->* table[i])(value);
+		}
+
+		/* Helpers to evaluate long flags and clusters of short flags,
+		 * and then the code for each individual flag. */
+		int evaluate_lflag(char *string);
+		int evaluate_sflags(char *string);
+
+		template<size_t I>
+		int evaluate(char *value);
+
+		template<size_t I, typename T>
+		int get_array(std::vector<T>& array, char *value);
+
+		/* Check whether a value converts for a flag without storing it
+		 * anywhere, for events(), through a jump table in the same way
+		 * as dispatch(). */
+		template<size_t... I>
+		static constexpr auto make_accepts(std::index_sequence<I...>) {
+			return std::array<bool (*)(char *), size>{
+				&schema::accepts<I>...
+			};
+		}
+
+		static bool accepts(size_t i, char *value) {
+			static constexpr auto table = make_accepts(
+				std::index_sequence_for<Flags...>()
+			);
+
+			return table[i](value);
+		}
+
+		template<size_t I>
+		static bool accepts(char *value);
+
+		/* Helpers for events(), which throw on errors. These find the
+		 * flag at ch, moving ch past it and finding any value stuck on
+		 * to it; check a flag's value, popping it if it needs to; get
+		 * the next element of an array; and check an array's length. */
+		size_t next_flag(char *&ch, std::string_view& name,
+			char *&value);
+
+		char *next_value(size_t i, char *value);
+		char *next_element(size_t i);
+		void check_length(size_t i, size_t length);
+
+		/* Error reporting, in the same format as the C library. */
+		void print_flag(size_t i) const;
+		int error(size_t i, int ret, const char *message);
+		int bad_value(size_t i, const char *value);
+		int unknown_flag(std::string_view name) const;
+
+		char *pop_arg() {
+			if(next_arg >= args_length) return nullptr;
+			return args[next_arg++];
+		}
+
+		/* The variables and functions the flags are bound to. */
+		std::tuple<typename Flags::binding_t...> bindings;
+
+		/* Parsing state; see LC_read() for how the arguments are
+		 * walked. */
+		char **args = nullptr;
+		size_t args_length = 0, next_arg = 0;
+		std::vector<char *> flagless;
+
+		std::bitset<size> seen;
+		bool processing_lflag = false;
+	};
+
+	/* Walk the arguments lazily with a schema; see schema::events(). */
+	template<typename... Flags>
+	generator<event> events(int argc, char **argv, schema<Flags...>& flags)
+	{
+		return flags.events(argc, argv);
+	}
+
+	template<typename... Flags>
+	int schema<Flags...>::parse(int argc, char **argv) {
+		args = argv;
+		args_length = argc;
+		next_arg = 1;
+		seen.reset();
+
+		/* There can't be more flagless arguments than arguments, so
+		 * the list only grows once for a given length of argv. */
+		flagless.clear();
+		if(argc > 1) flagless.reserve(argc - 1);
+
+		while(next_arg < args_length) {
+			char *string = args[next_arg++];
+
+			/* A `-' by itself or anything without a leading `-'
+			 * isn't a flag. */
+			if(string[0] != '-' || !string[1]) {
+				flagless.push_back(string);
+				continue;
+			}
+
+			/* A `--' marks the end of the flags. */
+			if(string[1] == '-' && !string[2]) break;
+
+			int ret = string[1] == '-'?
+				evaluate_lflag(string):
+				evaluate_sflags(string);
+
+			if(ret != LC_OK) return ret;
+		}
+
+		/* The remaining arguments are flagless arguments. */
+		while(next_arg < args_length) {
+			flagless.push_back(args[next_arg++]);
+		}
+
+		return LC_OK;
+	}
+
+	template<typename... Flags>
+	int schema<Flags...>::evaluate_lflag(char *string) {
+		processing_lflag = true;
+
+		/* Split the flag from its value at the first `='. */
+		char *equals_ch = std::strchr(&string[2], '=');
+		if(equals_ch) *equals_ch = 0;
+
+		char *value = equals_ch? equals_ch + 1: nullptr;
+		size_t i = find_lflag(&string[2]);
+
+		if(i >= size) return unknown_flag(&string[2]);
+
+		return dispatch(i, value);
+	}
+
+	template<typename... Flags>
+	int schema<Flags...>::evaluate_sflags(char *string) {
+		processing_lflag = false;
+
+		/* A flag that takes a value uses up the rest of the argument,
+		 * if there is any left. */
+		for(char *ch = &string[1]; *ch; ch++) {
+			size_t i = find_sflag(*ch);
+
+			if(i >= size) return unknown_flag({ch, 1});
+
+			char *value = takes_value[i] && ch[1]? &ch[1]: nullptr;
+
+			int ret = dispatch(i, value);
+
+			if(ret != LC_OK) return ret;
+			if(takes_value[i]) break;
+		}
+
+		return LC_OK;
+	}
+
+	template<typename... Flags>
+	template<size_t I>
+	int schema<Flags...>::evaluate(char *value) {
+		typedef typename std::tuple_element_t<I, std::tuple<Flags...>>
+			::type T;
+
+		auto& binding = std::get<I>(bindings);
+
+		/* Make sure that the flag isn't being set a second time. */
+		if(seen[I]) {
+			return error(I, LC_VAR_RESET,
+				"has been set multiple times"
+			);
+		}
+		seen[I] = true;
+
+		if constexpr(!takes_value[I]) {
+			if(value) {
+				return error(I, LC_BAD_VAL,
+					"does not take any values"
+				);
+			}
+
+			if constexpr(std::is_void_v<T>) binding();
+			else binding = true;
+
+			return LC_OK;
+		}
+
+		else if constexpr(__is_vector<T>::value) {
+			return get_array<I>(binding, value);
+		}
+
+		else {
+			if(!value) value = pop_arg();
+			if(!value) {
+				return error(I, LC_NO_VAL,
+					"needs an additional argument"
+				);
+			}
+
+			if(!__schema_convert(value, binding)) {
+				return bad_value(I, value);
+			}
+
+			return LC_OK;
+		}
+	}
+
+	template<typename... Flags>
+	template<size_t I, typename T>
+	int schema<Flags...>::get_array(std::vector<T>& array, char *value) {
+		typedef std::tuple_element_t<I, std::tuple<Flags...>> F;
+
+		/* The array's storage is reused from any previous parse. */
+		array.clear();
+		T element{};
+
+		if(value) {
+			if(!__schema_convert(value, element)) {
+				return bad_value(I, value);
+			}
+
+			array.push_back(std::move(element));
+		}
+
+		/* The values run up to the next `--', which is consumed, or the
+		 * first value that doesn't convert, which isn't. */
+		while(next_arg < args_length) {
+			char *string = args[next_arg];
+
+			if(string[0] == '-' && string[1] == '-' && !string[2]) {
+				next_arg++;
+				break;
+			}
+
+			if(!__schema_convert(string, element)) break;
+
+			array.push_back(std::move(element));
+			next_arg++;
+		}
+
+		if(array.size() < F::min_length) {
+			return error(I, LC_LESS_VALS,
+				"has too few arguments provided"
+			);
+		}
+
+		if(array.size() > F::max_length) {
+			return error(I, LC_MORE_VALS,
+				"has too many arguments provided"
+			);
+		}
+
+		return LC_OK;
+	}
+
+	template<typename... Flags>
+	template<size_t I>
+	bool schema<Flags...>::accepts(char *value) {
+		typedef typename std::tuple_element_t<I, std::tuple<Flags...>>
+			::type T;
+
+		/* Strings take anything, so only numbers need checking. */
+		if constexpr(__is_vector<T>::value) {
+			typedef typename T::value_type E;
+			if constexpr(!std::is_arithmetic_v<E>) return true;
+
+			else {
+				E element{};
+				return __schema_convert(value, element);
+			}
+		}
+
+		else if constexpr(std::is_arithmetic_v<T>
+			&& !std::is_same_v<T, bool>)
+		{
+			T element{};
+			return __schema_convert(value, element);
+		}
+
+		else return true;
+	}
+
+	template<typename... Flags>
+	generator<event> schema<Flags...>::events(int argc, char **argv) {
+		args = argv;
+		args_length = argc;
+		next_arg = 1;
+		seen.reset();
+
+		bool end_of_flags = false;
+
+		while(next_arg < args_length) {
+			char *string = args[next_arg++];
+
+			/* The same rules as parse() for what isn't a flag. */
+			if(end_of_flags || string[0] != '-' || !string[1]) {
+				co_yield {event_kind::positional, size, string};
+				continue;
+			}
+
+			if(string[1] == '-' && !string[2]) {
+				end_of_flags = true;
+				continue;
+			}
+
+			/* A long flag is a single flag, but a cluster of short
+			 * flags has as many as there are characters up to the
+			 * first one that takes a value. */
+			processing_lflag = string[1] == '-';
+			char *ch = &string[processing_lflag? 2: 1];
+
+			while(*ch) {
+				std::string_view name;
+				char *value = nullptr;
+
+				size_t i = next_flag(ch, name, value);
+				co_yield {event_kind::flag, i, name};
+
+				if(!takes_value[i]) continue;
+
+				if(!takes_array[i]) {
+					value = next_value(i, value);
+					co_yield {event_kind::value, i, value};
+					continue;
+				}
+
+				size_t length = 0;
+
+				if(value) {
+					value = next_value(i, value);
+					co_yield {event_kind::value, i, value};
+					length++;
+				}
+
+				while((value = next_element(i))) {
+					co_yield {event_kind::value, i, value};
+					length++;
+				}
+
+				check_length(i, length);
+			}
+		}
+	}
+
+	template<typename... Flags>
+	size_t schema<Flags...>::next_flag(char *&ch, std::string_view& name,
+		char *&value)
+	{
+		size_t i;
+
+		/* A long flag's value comes after the first `=', and a short
+		 * flag's value is whatever is left of the argument. */
+		if(processing_lflag) {
+			char *equals_ch = std::strchr(ch, '=');
+			name = equals_ch? std::string_view(ch, equals_ch): ch;
+
+			if(equals_ch) value = equals_ch + 1;
+			ch += std::strlen(ch);
+
+			i = find_lflag(name);
+		}
+
+		else {
+			name = {ch, 1};
+			i = find_sflag(*ch++);
+
+			if(i < size && takes_value[i] && *ch) {
+				value = ch;
+				ch += std::strlen(ch);
+			}
+		}
+
+		if(i >= size) {
+			throw exception(unknown_flag(name));
+		}
+
+		if(seen[i]) {
+			throw exception(error(i, LC_VAR_RESET,
+				"has been set multiple times"
+			));
+		}
+		seen[i] = true;
+
+		if(!takes_value[i] && value) {
+			throw exception(error(i, LC_BAD_VAL,
+				"does not take any values"
+			));
+		}
+
+		return i;
+	}
+
+	template<typename... Flags>
+	char *schema<Flags...>::next_value(size_t i, char *value) {
+		if(!value) value = pop_arg();
+
+		if(!value) {
+			throw exception(error(i, LC_NO_VAL,
+				"needs an additional argument"
+			));
+		}
+
+		if(!accepts(i, value)) {
+			throw exception(bad_value(i, value));
+		}
+
+		return value;
+	}
+
+	template<typename... Flags>
+	char *schema<Flags...>::next_element(size_t i) {
+		if(next_arg >= args_length) return nullptr;
+		char *string = args[next_arg];
+
+		/* The same rules as get_array() for where an array ends. */
+		if(string[0] == '-' && string[1] == '-' && !string[2]) {
+			next_arg++;
+			return nullptr;
+		}
+
+		if(!accepts(i, string)) return nullptr;
+
+		next_arg++;
+		return string;
+	}
+
+	template<typename... Flags>
+	void schema<Flags...>::check_length(size_t i, size_t length) {
+		if(length < min_lengths[i]) {
+			throw exception(error(i, LC_LESS_VALS,
+				"has too few arguments provided"
+			));
+		}
+
+		if(length > max_lengths[i]) {
+			throw exception(error(i, LC_MORE_VALS,
+				"has too many arguments provided"
+			));
+		}
+	}
+
+	template<typename... Flags>
+	void schema<Flags...>::print_flag(size_t i) const {
+		/* Print the kind of flag we're processing if the flag has
+		 * one, and the other kind if it doesn't. */
+		bool lflag = lflags[i].size() && (
+			processing_lflag || !sflags[i]
+		);
+
+		if(lflag) {
+			std::fprintf(stderr, "'--%.*s'",
+				(int) lflags[i].size(), lflags[i].data()
+			);
+		}
+
+		else std::fprintf(stderr, "'-%c'", sflags[i]);
+	}
+
+	template<typename... Flags>
+	int schema<Flags...>::error(size_t i, int ret, const char *message) {
+		std::fprintf(stderr, "%s: error: the flag ", args[0]);
+		print_flag(i);
+		std::fprintf(stderr, " %s.\n", message);
+
+		return ret;
+	}
+
+	template<typename... Flags>
+	int schema<Flags...>::bad_value(size_t i, const char *value) {
+		std::fprintf(stderr, "%s: error: the string `%s' is invalid "
+			"for the flag ", args[0], value
+		);
+		print_flag(i);
+		std::fprintf(stderr, ".\n");
+
+		return LC_BAD_VAL;
+	}
+
+	template<typename... Flags>
+	int schema<Flags...>::unknown_flag(std::string_view name) const {
+		std::fprintf(stderr, "%s: error: unknown flag '%s%.*s'.\n",
+			args[0], processing_lflag? "--": "-", (int) name.size(),
+			name.data()
+		);
+
+		return LC_BAD_FLAG;
+	}
+};
+
+/* End Header Guard */
+#endif
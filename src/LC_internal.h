@@ -0,0 +1,388 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+/* This header is shared between the library's translation units and is not
+ * installed alongside the public headers. */
+
+/* Begin Header Guard */
+#ifndef LC_INTERNAL_H
+#define LC_INTERNAL_H 1
+
+/* Main Program Header. */
+#include <libClame.h>
+
+/* The allocator that goes straight to malloc(), realloc() and free(). */
+extern const LC_allocator_t __LC_default_allocator;
+
+static inline void *__LC_realloc(const LC_allocator_t *allocator, void *ptr,
+	size_t size)
+{
+	return allocator -> realloc(allocator -> context, ptr, size);
+}
+
+static inline void __LC_free(const LC_allocator_t *allocator, void *ptr) {
+	allocator -> free(allocator -> context, ptr);
+}
+
+/* Lookup index over a flags array. Long flags are kept in an open-addressing
+ * hash table whose size is a power of two, so that a lookup costs one hash of
+ * the argument plus (almost always) a single strcmp(). Short flags are looked
+ * up directly by their byte value. */
+typedef struct {
+	size_t hash;
+	LC_flag_t *flag; // NULL if the slot is empty.
+
+} __LC_slot_t;
+
+typedef struct {
+	/* The array the index was built for. */
+	LC_flag_t *flags;
+	size_t flags_length;
+
+	/* Hash table of long flags. */
+	__LC_slot_t *slots;
+	size_t mask;
+
+	/* Short flag dispatch table. Entry 0 is always NULL, since a short flag
+	 * of zero means that the flag doesn't have one. */
+	LC_flag_t *sflags[256];
+
+} __LC_index_t;
+
+/* Build the index for an array of flags, replacing whatever the index held
+ * previously. Duplicate long or short flags are reported on stderr and
+ * LC_DUP_FLAG is returned. */
+extern int __LC_index_build(__LC_index_t *index, LC_flag_t *flags,
+	size_t flags_length, const char *prog_name);
+
+/* Release the memory held by an index. */
+extern void __LC_index_free(__LC_index_t *index);
+
+/* Find the flag matching the first length bytes of a long flag name, or NULL
+ * if there isn't one. */
+extern LC_flag_t *__LC_index_lflag(const __LC_index_t *index,
+	const char *lflag, size_t length);
+
+/* Find the flag matching a short flag, or NULL if there isn't one. */
+static inline LC_flag_t *__LC_index_sflag(const __LC_index_t *index,
+	char sflag)
+{
+	return index -> sflags[(unsigned char) sflag];
+}
+
+/* Split the next whitespace-separated token out of the buffer between *cursor
+ * and end, handling quotes and backslash escapes the way a POSIX shell does.
+ * The token is unquoted and null-terminated in place, and *cursor is moved past
+ * it. NULL is returned once there are no tokens left. The byte at end must be
+ * writable, since the last token's null byte may need to go there. */
+extern char *__LC_next_token(char **cursor, char *end);
+
+/* A memory-mapped response file. */
+typedef struct {
+	void *addr;
+	size_t length;
+
+} __LC_mapping_t;
+
+/* Argument list with any `@file' response files expanded. The tokens point
+ * straight into the mapped files, which stay mapped until the next expansion
+ * or until the expansion is cleared. */
+typedef struct {
+	/* The arguments to walk: either the original argv or `args'. */
+	char **argv;
+	size_t argc;
+
+	/* Storage for the expanded list, reused between calls. */
+	char **args;
+	size_t length, capacity;
+
+	/* The files that the tokens point into. */
+	__LC_mapping_t *maps;
+	size_t maps_length, maps_capacity;
+
+	/* Where the storage comes from; set by whoever owns the expansion. */
+	const LC_allocator_t *allocator;
+
+} __LC_expansion_t;
+
+/* Expand the response files in argv[1..argc), nesting at most max_depth files
+ * deep. Arguments naming files that can't be opened are kept as they are. */
+extern int __LC_expand(__LC_expansion_t *expansion, int argc, char **argv,
+	size_t max_depth, const char *prog_name);
+
+/* Map a file into memory with at least one zeroed byte after its end, so that
+ * the last token in the file can be null-terminated in place. The mapping is
+ * private, so none of the changes we make get written back to the file, and it
+ * lasts until the expansion is next cleared. NULL is returned on failure. */
+extern char *__LC_map_file(__LC_expansion_t *expansion, int fd, size_t size);
+
+/* Unmap the files from the last expansion, keeping the storage around. */
+extern void __LC_expansion_clear(__LC_expansion_t *expansion);
+
+/* Unmap the files and release the storage as well. */
+extern void __LC_expansion_free(__LC_expansion_t *expansion);
+
+/* Native conversion for the integer formats sscanf() understands. Going
+ * around sscanf() avoids its locale handling and lets us reject values that
+ * don't fit the variable rather than silently wrapping them around. Floating
+ * point formats go straight to strtod() and friends, which accept exactly
+ * what sscanf() would. */
+typedef enum {
+	__LC_INTEGER, __LC_FLOAT, __LC_DOUBLE, __LC_LONG_DOUBLE
+
+} __LC_number_type_t;
+
+typedef struct {
+	__LC_number_type_t type;
+	size_t size; // Size of the variable in bytes.
+
+	/* These are only used for integers. */
+	bool is_signed;
+	unsigned base; // 8, 10 or 16, or 0 to work it out like %i.
+
+} __LC_number_t;
+
+/* Work out whether a format string is a single numeric conversion we can
+ * handle natively, such as "%d", "%" SCNu8, "%zx" or "%lf". */
+extern bool __LC_number_format(const char *fmt, __LC_number_t *number);
+
+/* Convert the number at the start of a string, storing it in dest. Returns a
+ * pointer to the first character after the number, or NULL if there isn't a
+ * valid number there or the value doesn't fit. */
+extern const char *__LC_number_scan(const __LC_number_t *number,
+	const char *string, void *dest);
+
+/* Convert a whole string to a number, storing it in dest. Returns false if the
+ * string isn't a valid number or the value doesn't fit. */
+static inline bool __LC_number_parse(const __LC_number_t *number,
+	const char *string, void *dest)
+{
+	const char *end = __LC_number_scan(number, string, dest);
+	return end && !*end;
+}
+
+/* Work through the items [0, count) on up to the given number of threads,
+ * calling a job on consecutive runs of them. Each call returns where in its
+ * run it stopped, or the end of the run if it got through all of it, and
+ * __LC_parallel() returns the first place that any of them stopped, or count.
+ * The calling thread always does the first run itself. Work that keeps the
+ * processors busy should pass the number of threads through __LC_threads()
+ * first; work that mostly waits shouldn't. */
+typedef size_t (*__LC_job_t)(void *context, size_t begin, size_t end);
+
+extern size_t __LC_parallel(__LC_job_t job, void *context, size_t count,
+	size_t threads);
+
+/* Cap a number of threads at the number of processors that are online. */
+extern size_t __LC_threads(size_t threads);
+
+/* Convert count values into consecutive elements of size bytes from dest
+ * onwards, splitting them between up to the given number of threads. Returns
+ * the index of the first value that doesn't convert, or count if they all do.
+ * Values after that one may or may not have been converted. */
+typedef bool (*__LC_convert_t)(const void *converter, const char *value,
+	void *dest);
+
+extern size_t __LC_convert_all(__LC_convert_t convert, const void *converter,
+	char **values, size_t count, void *dest, size_t size, size_t threads);
+
+/* What an argument looks like. Only flags have their length worked out, since
+ * nothing else needs it, along with the offset of their first `=', which
+ * splits a long flag from its value. */
+typedef enum {
+	__LC_FLAGLESS, // Doesn't start with a `-'.
+	__LC_DASH, // Just a `-'.
+	__LC_DOUBLE_DASH, // Just a `--'.
+	__LC_SHORT_FLAGS, // One or more short flags after a `-'.
+	__LC_LONG_FLAG // A long flag after a `--'.
+
+} __LC_kind_t;
+
+typedef struct {
+	size_t length;
+	size_t equals; // 0 if there's no value after an `='.
+	__LC_kind_t kind;
+
+} __LC_class_t;
+
+/* Find the length of a flag and its first `=' in a single pass, which uses
+ * SSE2 where it's available. */
+extern void __LC_scan(const char *string, __LC_class_t *class);
+
+/* Count how many times a character appears in a string, the same way. */
+extern size_t __LC_count(const char *string, char ch);
+
+/* Work out what an argument looks like. Most arguments are worked out from
+ * their first few bytes, and only flags have to be scanned to the end. */
+static inline void __LC_classify(const char *string, __LC_class_t *class) {
+	class -> length = class -> equals = 0;
+
+	if(string[0] != '-') class -> kind = __LC_FLAGLESS;
+
+	else if(!string[1]) {
+		class -> kind = __LC_DASH;
+		class -> length = 1;
+	}
+
+	else if(string[1] == '-' && !string[2]) {
+		class -> kind = __LC_DOUBLE_DASH;
+		class -> length = 2;
+	}
+
+	else {
+		class -> kind = string[1] == '-'?
+			__LC_LONG_FLAG: __LC_SHORT_FLAGS;
+
+		__LC_scan(string, class);
+	}
+}
+
+/* What an argument looks like, along with the flag it names if it's a long
+ * flag, worked out ahead of time. */
+typedef struct {
+	__LC_class_t class;
+	LC_flag_t *flag;
+
+} __LC_lookup_t;
+
+/* An array flag's variable that holds an array we have allocated, along with
+ * that array and how many bytes it has room for, so that parsing into the same
+ * variable again can reuse the room without going back to the allocator. If
+ * the variable has been pointed somewhere else since, the room is unknown. */
+typedef struct {
+	void **array;
+	size_t *length;
+
+	void *data;
+	size_t size;
+
+} __LC_owned_t;
+
+/* Internal state of an LC_parser_t. */
+typedef struct __LC_state_s {
+	/* Lookup index for the parser's flags. It is only rebuilt when the
+	 * parser is given a different flags array. */
+	__LC_index_t index;
+
+	/* Whether each flag has been seen during the current parse, and where
+	 * its variable is in the owned arrays below, plus one, or zero if it
+	 * isn't there yet. These belong to the flags array rather than to a
+	 * parse, so they always come from malloc(). */
+	bool *seen;
+	size_t *owned_flags;
+
+	/* Whether each flag's callback function is waiting to be run at the
+	 * end of the parse and what it returned, the flags whose callback
+	 * functions are waiting in the order they were given, and the ones
+	 * that can run on other threads. These come from malloc() for the
+	 * same reason. */
+	struct {
+		bool queued;
+		int ret;
+
+	} *calls;
+
+	size_t *queue;
+	size_t queue_length;
+
+	size_t *independent;
+	size_t independent_length;
+
+	/* The argument list after response files have been expanded. */
+	__LC_expansion_t expansion;
+
+	/* The flagless arguments array is kept between calls and only grows
+	 * when it has to. */
+	size_t flagless_args_capacity;
+
+	/* The arguments are walked in place rather than being copied anywhere:
+	 * every argument before args[next_arg] has already been consumed, and
+	 * every value a flag takes is always the next unconsumed argument. */
+	char **args;
+	size_t args_length;
+	size_t next_arg;
+
+	/* The argument being dealt with and the flag in it, for reporting
+	 * where a parse went wrong, and how many of the arguments fed in
+	 * have been dealt with so far, counting the program name. */
+	size_t arg;
+	LC_flag_t *flag;
+	size_t fed;
+
+	/* Set to true if we are processing a long flag, false if it's a short
+	 * flag. */
+	bool processing_lflag;
+
+	/* Set once a `--' has been seen, after which nothing is a flag. */
+	bool end_of_flags;
+
+	/* Arguments fed in with LC_feed() that can't be evaluated yet, because
+	 * the first of them is a flag still waiting on its values, along with
+	 * how far we've looked for the end of its array. */
+	bool feeding;
+	int feed_ret;
+
+	char **pending;
+	size_t pending_length, pending_capacity;
+	size_t feed_scanned;
+
+	/* What the arguments from looked_begin up to looked_end look like,
+	 * which LC_parse() works out in a sweep ahead of walking them. Whether
+	 * an argument is actually a flag still depends on the arguments before
+	 * it, so these are only looked at once the walk gets to a flag.
+	 * Arguments that are fed in are worked out as the walk gets to them
+	 * instead. */
+	__LC_lookup_t *lookups;
+	size_t lookups_capacity;
+	size_t looked_begin, looked_end;
+	bool looked_up;
+
+	/* Room for the parser's list of failed callback functions. */
+	size_t function_errors_capacity;
+
+	/* Storage for the tokens LC_parse_string() splits a string into,
+	 * reused between calls. */
+	char **tokens;
+	size_t tokens_capacity;
+
+	/* The array flags' variables that hold arrays we have allocated, and
+	 * that get released along with everything else from the last parse. */
+	__LC_owned_t *owned;
+
+	size_t owned_length, owned_capacity;
+
+	/* Where everything a parse hands back comes from. */
+	LC_allocator_t allocator;
+
+	/* The blocks that LC_parse_fd() reads arguments into, which last until
+	 * the next parse, and whether any argument in the newest block has been
+	 * stored somewhere, so that the block can't be reused. */
+	char **blocks;
+	size_t blocks_length, blocks_capacity;
+	bool stored;
+
+} __LC_state_t;
+
+/* Release the blocks that LC_parse_fd() read arguments into, keeping the array
+ * that tracks them. */
+extern void __LC_blocks_free(LC_parser_t *parser);
+
+/* Note down where the parse stopped if it went wrong, and pass the return
+ * value through. */
+extern int __LC_stopped(LC_parser_t *parser, int ret);
+
+/* End Header Guard */
+#endif
@@ -0,0 +1,166 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "LC_internal.h"
+
+/* The default allocator just goes to the C library. */
+static void *default_realloc(void *context, void *ptr, size_t size) {
+	(void) context;
+	return realloc(ptr, size);
+}
+
+static void default_free(void *context, void *ptr) {
+	(void) context;
+	free(ptr);
+}
+
+const LC_allocator_t __LC_default_allocator = {
+	default_realloc, default_free, NULL, NULL
+};
+
+/* Arena blocks are handed out from front to back. Every allocation starts
+ * with a header holding its size, so that realloc() knows how much to copy,
+ * and the last allocation in a block can grow in place. */
+typedef union {
+	long double ld;
+	long long ll;
+	void *ptr;
+	void (*func)(void);
+
+} align_t;
+
+#define ALIGN sizeof(align_t)
+#define ROUND_UP(size) (((size) + ALIGN - 1) / ALIGN * ALIGN)
+
+struct __LC_block_s {
+	struct __LC_block_s *next;
+	size_t capacity, used;
+	char *last; // The last allocation made in the block, if any.
+
+	align_t data[]; // Aligned for anything.
+};
+
+typedef struct {
+	size_t size;
+
+} header_t;
+
+#define HEADER ROUND_UP(sizeof(header_t))
+
+void LC_arena_init(LC_arena_t *arena, size_t block_size) {
+	arena -> blocks = NULL;
+	arena -> block_size = block_size? block_size: 64 * 1024;
+}
+
+/* Get room for an allocation at the front of the arena, adding a new block if
+ * the current one is too full. */
+static char *arena_alloc(LC_arena_t *arena, size_t size) {
+	size_t needed = HEADER + ROUND_UP(size);
+	struct __LC_block_s *block = arena -> blocks;
+
+	if(!block || block -> capacity - block -> used < needed) {
+		size_t capacity = needed > arena -> block_size?
+			needed: arena -> block_size;
+
+		block = malloc(sizeof(struct __LC_block_s) + capacity);
+		if(!block) return NULL;
+
+		block -> next = arena -> blocks;
+		block -> capacity = capacity;
+		block -> used = 0;
+		block -> last = NULL;
+		arena -> blocks = block;
+	}
+
+	char *ptr = (char *) block -> data + block -> used + HEADER;
+	((header_t *) (ptr - HEADER)) -> size = size;
+
+	block -> used += needed;
+	block -> last = ptr;
+	return ptr;
+}
+
+static void *arena_realloc(void *context, void *ptr, size_t size) {
+	LC_arena_t *arena = context;
+	if(!ptr) return arena_alloc(arena, size);
+
+	header_t *header = (header_t *) ((char *) ptr - HEADER);
+	struct __LC_block_s *block = arena -> blocks;
+
+	/* The last allocation can just take more of its block. */
+	if(block && block -> last == ptr) {
+		size_t start = (char *) ptr - (char *) block -> data;
+
+		if(block -> capacity - start >= ROUND_UP(size)) {
+			block -> used = start + ROUND_UP(size);
+			header -> size = size;
+			return ptr;
+		}
+	}
+
+	/* Anything else has to move. The old copy is only reclaimed when the
+	 * arena is reset. */
+	char *new_ptr = arena_alloc(arena, size);
+	if(!new_ptr) return NULL;
+
+	memcpy(new_ptr, ptr, header -> size < size? header -> size: size);
+	return new_ptr;
+}
+
+static void arena_free(void *context, void *ptr) {
+	(void) context;
+	(void) ptr;
+}
+
+static void arena_reset(void *context) {
+	LC_arena_reset(context);
+}
+
+LC_allocator_t LC_arena_allocator(LC_arena_t *arena) {
+	LC_allocator_t allocator = {
+		arena_realloc, arena_free, arena_reset, arena
+	};
+
+	return allocator;
+}
+
+void LC_arena_reset(LC_arena_t *arena) {
+	struct __LC_block_s *block = arena -> blocks;
+	if(!block) return;
+
+	/* Hold on to the newest block, which is the one we'd allocate from
+	 * next anyway. */
+	struct __LC_block_s *next = block -> next;
+
+	while(next) {
+		struct __LC_block_s *after = next -> next;
+		free(next);
+		next = after;
+	}
+
+	block -> next = NULL;
+	block -> used = 0;
+	block -> last = NULL;
+}
+
+void LC_arena_free(LC_arena_t *arena) {
+	LC_arena_reset(arena);
+	free(arena -> blocks);
+	arena -> blocks = NULL;
+}
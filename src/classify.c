@@ -0,0 +1,113 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <stdint.h>
+
+#include "LC_internal.h"
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+
+/* Reading the whole aligned block around a string reads memory that isn't
+ * part of it, which is safe since an aligned load never crosses into another
+ * page, but which AddressSanitizer would complain about. The C library's own
+ * strlen() does the same thing. */
+#ifdef __SANITIZE_ADDRESS__
+#define NO_SANITIZE __attribute__((no_sanitize_address))
+#else
+#define NO_SANITIZE
+#endif
+
+/* Compare every byte in a block against a character. */
+static unsigned match(__m128i bytes, char ch) {
+	return (unsigned) _mm_movemask_epi8(
+		_mm_cmpeq_epi8(bytes, _mm_set1_epi8(ch))
+	);
+}
+
+/* Look for the null byte and the first `=' sixteen bytes at a time. */
+NO_SANITIZE void __LC_scan(const char *string, __LC_class_t *class) {
+	uintptr_t offset = (uintptr_t) string & 15;
+	const char *block = string - offset;
+
+	/* Ignore whatever comes before the string in the first block. */
+	unsigned mask = (0xffffu << offset) & 0xffffu;
+	class -> equals = 0;
+
+	for(;; block += 16, mask = 0xffffu) {
+		__m128i bytes = _mm_load_si128((const __m128i *) block);
+
+		unsigned nulls = match(bytes, 0) & mask;
+		unsigned eqs = match(bytes, '=') & mask;
+
+		/* Only an `=' before the null byte counts. */
+		if(nulls) eqs &= (nulls & -nulls) - 1;
+
+		if(eqs && !class -> equals) {
+			class -> equals = block + __builtin_ctz(eqs) - string;
+		}
+
+		if(nulls) {
+			class -> length = block + __builtin_ctz(nulls) - string;
+			return;
+		}
+	}
+}
+
+NO_SANITIZE size_t __LC_count(const char *string, char ch) {
+	uintptr_t offset = (uintptr_t) string & 15;
+	const char *block = string - offset;
+
+	unsigned mask = (0xffffu << offset) & 0xffffu;
+	size_t count = 0;
+
+	for(;; block += 16, mask = 0xffffu) {
+		__m128i bytes = _mm_load_si128((const __m128i *) block);
+
+		unsigned nulls = match(bytes, 0) & mask;
+		unsigned found = match(bytes, ch) & mask;
+
+		if(nulls) found &= (nulls & -nulls) - 1;
+		count += __builtin_popcount(found);
+
+		if(nulls) return count;
+	}
+}
+
+#else
+
+/* Look for the null byte and the first `=' a byte at a time. */
+void __LC_scan(const char *string, __LC_class_t *class) {
+	const char *ch = string;
+	class -> equals = 0;
+
+	for(; *ch; ch++) {
+		if(*ch == '=' && !class -> equals) {
+			class -> equals = ch - string;
+		}
+	}
+
+	class -> length = ch - string;
+}
+
+size_t __LC_count(const char *string, char ch) {
+	size_t count = 0;
+
+	for(; *string; string++) count += *string == ch;
+	return count;
+}
+
+#endif
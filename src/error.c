@@ -20,6 +20,9 @@
 int (*LC_err_function)() = NULL;
 int LC_function_errno = 0;
 
+size_t LC_err_index = 0;
+LC_flag_t *LC_err_flag = NULL;
+
 /* Get error strings. */
 const char *LC_strerror(int error) {
 	/* Return the compile-time constant's name. */
@@ -38,6 +41,9 @@ const char *LC_strerror(int error) {
 
 		case LC_BAD_VAR_TYPE: return "LC_BAD_VAR_TYPE";
 		case LC_NULL_FORMAT_STR: return "LC_NULL_FORMAT_STR";
+		case LC_DUP_FLAG: return "LC_DUP_FLAG";
+		case LC_RESPONSE_ERR: return "LC_RESPONSE_ERR";
+		case LC_READ_ERR: return "LC_READ_ERR";
 	}
 
 	/* We have an invalid error number. */
@@ -0,0 +1,137 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "LC_internal.h"
+
+/* 64-bit FNV-1a; it's short and fast enough for flag names. The length is
+ * passed in, since a long flag may be followed by an `=' and its value. */
+static size_t hash_string(const char *string, size_t length) {
+	uint64_t hash = UINT64_C(14695981039346656037);
+
+	for(const char *end = string + length; string < end; string++) {
+		hash ^= (unsigned char) *string;
+		hash *= UINT64_C(1099511628211);
+	}
+
+	return (size_t) hash;
+}
+
+int __LC_index_build(__LC_index_t *index, LC_flag_t *flags,
+	size_t flags_length, const char *prog_name)
+{
+	/* Get rid of any previous table first. */
+	__LC_index_free(index);
+
+	/* Keep the load factor at or below one half so probe sequences stay
+	 * short even for tables with thousands of flags. */
+	size_t capacity = 1;
+	while(capacity < flags_length * 2) capacity <<= 1;
+
+	index -> slots = calloc(capacity, sizeof(__LC_slot_t));
+	if(!index -> slots) return LC_MALLOC_ERR;
+
+	index -> mask = capacity - 1;
+
+	for(size_t i = 0; i < flags_length; i++) {
+		LC_flag_t *flag = &flags[i];
+
+		/* A short flag of zero means that there isn't one. */
+		unsigned char sflag = (unsigned char) flag -> short_flag;
+
+		if(sflag && index -> sflags[sflag]) {
+			fprintf(stderr, "%s: error: the flag '-%c' is defined "
+				"multiple times.\n", prog_name, sflag
+			);
+
+			__LC_index_free(index);
+			return LC_DUP_FLAG;
+		}
+
+		if(sflag) index -> sflags[sflag] = flag;
+
+		/* Flags without a long name don't go in the hash table. */
+		if(!flag -> long_flag) continue;
+
+		size_t hash = hash_string(flag -> long_flag,
+			strlen(flag -> long_flag)
+		);
+
+		size_t slot = hash & index -> mask;
+
+		/* Linear probing until we find an empty slot. */
+		for(; index -> slots[slot].flag; slot = (slot + 1) & index -> mask)
+		{
+			if(index -> slots[slot].hash != hash) continue;
+
+			if(strcmp(index -> slots[slot].flag -> long_flag,
+				flag -> long_flag)) continue;
+
+			fprintf(stderr, "%s: error: the flag '--%s' is defined "
+				"multiple times.\n", prog_name, flag -> long_flag
+			);
+
+			__LC_index_free(index);
+			return LC_DUP_FLAG;
+		}
+
+		index -> slots[slot].hash = hash;
+		index -> slots[slot].flag = flag;
+	}
+
+	/* Only remember the table once the index is fully usable. */
+	index -> flags = flags;
+	index -> flags_length = flags_length;
+	return LC_OK;
+}
+
+void __LC_index_free(__LC_index_t *index) {
+	free(index -> slots);
+
+	index -> flags = NULL;
+	index -> flags_length = 0;
+	index -> slots = NULL;
+	index -> mask = 0;
+
+	for(size_t i = 0; i < 256; i++) index -> sflags[i] = NULL;
+}
+
+LC_flag_t *__LC_index_lflag(const __LC_index_t *index, const char *lflag,
+	size_t length)
+{
+	size_t hash = hash_string(lflag, length);
+	size_t slot = hash & index -> mask;
+
+	/* An empty slot ends the probe sequence. */
+	for(; index -> slots[slot].flag; slot = (slot + 1) & index -> mask) {
+		if(index -> slots[slot].hash != hash) continue;
+
+		LC_flag_t *flag = index -> slots[slot].flag;
+
+		if(!strncmp(flag -> long_flag, lflag, length)
+			&& !flag -> long_flag[length])
+		{
+			return flag;
+		}
+	}
+
+	/* Return NULL if we found nothing. */
+	return NULL;
+}
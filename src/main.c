@@ -19,7 +19,16 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include <libClame.h>
+#include "LC_internal.h"
+
+/* Below this many values or arguments, starting threads costs more than it
+ * saves. */
+#define CONVERT_THRESHOLD 65536
+#define PARSE_THRESHOLD 65536
+
+/* How many arguments are looked up at a time on the calling thread. This keeps
+ * the arguments in the cache between being looked up and being walked. */
+#define LOOK_UP_WINDOW 256
 
 /* Instantiate most of the variables externed in the header. */
 LC_flag_t *LC_flags = NULL;
@@ -28,183 +37,928 @@ size_t LC_flags_length = 0;
 char **LC_flagless_args = NULL;
 size_t LC_flagless_args_length = 0;
 
+int (*LC_flagless_function)(void *context, char *arg) = NULL;
+void *LC_flagless_context = NULL;
+
 char *LC_prog_name = NULL;
 
-/* We'll hold the arguments in a linked list. */
-typedef struct node_s {
-	struct node_s *next, *prev;
+size_t LC_response_depth = 0;
 
-	/* NULL-terminated C strings my beloved. */
-	char *string;
+size_t LC_convert_threads = 0;
+size_t LC_convert_threshold = CONVERT_THRESHOLD;
+size_t LC_parse_threads = 0;
 
-} node_t;
+bool LC_defer_functions = false;
+size_t LC_function_threads = 0;
 
-/* The root node is statically-allocated. */
-static node_t root = {NULL, NULL, NULL};
+LC_function_error_t *LC_function_errors = NULL;
+size_t LC_function_errors_length = 0;
 
-/* Helper flags to evaluate long and short flags. These will delete all nodes
- * for values relating to the flag except the node that they take as input. */
-static int evaluate_lflag(node_t *node);
-static int evaluate_sflags(node_t *node);
+/* The parser behind LC_read() and the global variables. */
+static LC_parser_t global_parser;
 
-/* Set to true if we are processing a long flag, false if it's a short flag. */
-static bool processing_lflag;
+/* Get a parser ready for a new set of arguments, and then evaluate the next
+ * argument, whatever it turns out to be. */
+static int begin_parse(LC_parser_t *parser, char *prog_name);
+static int parse_arg(LC_parser_t *parser);
 
-/* Helper for evaluating all sflags in a node. It returns either LC_OK or this
- * custom non-error status. */
-static int evaluate_sflag(node_t *node, char sflag, char *value);
-#define LC_OK_VALUE_USED -1
+/* Walk a whole set of arguments for LC_parse(). */
+static int parse_args(LC_parser_t *parser, int argc, char **argv);
 
-/* This finds a flag that matches either the specified long or short flag. */
-static LC_flag_t *find_flag(const char *lflag, char sflag);
+/* Classify the arguments and look up the long flags in a sweep ahead of
+ * walking them. The calling thread sweeps a window of arguments whenever the
+ * walk runs past the last one, and several threads sweep all of them up front
+ * if there are enough arguments to make it worthwhile and the parser allows
+ * it. */
+static int look_up_args(LC_parser_t *parser);
+static void look_up_window(LC_parser_t *parser, size_t arg);
+static size_t look_up_run(void *context, size_t begin, size_t end);
 
-/* These two find value or values for a variable based on the flag that it
- * was specified in. If a candidate value for was specified in the same node
- * as the flag was specified, then a pointer to the start of that value string
- * is also passed along. */
+/* Evaluate the pending arguments fed to a parser for as long as the first of
+ * them has all of its values, or until they run out if we're finishing. */
+static int drain_pending(LC_parser_t *parser, bool finish);
+static bool pending_ready(LC_parser_t *parser);
+
+/* Helper flags to evaluate long and short flags. These take the argument the
+ * flag was found in along with its length, and consume any further arguments
+ * they need as values. */
+static int evaluate_lflag(LC_parser_t *parser, char *string, size_t length,
+	size_t equals, LC_flag_t *flag);
+static int evaluate_sflags(LC_parser_t *parser, char *string, size_t length);
+
+/* Helper for evaluating all sflags in an argument. It returns either LC_OK or
+ * this custom non-error status. */
+static int evaluate_sflag(LC_parser_t *parser, char sflag, char *value);
+
+#define LC_OK_VALUE_USED -1
+
+/* Mark a flag as seen, and run its callback function once its variable has
+ * been dealt with. */
+static int mark_seen(LC_parser_t *parser, LC_flag_t *flag);
+static int run_function(LC_parser_t *parser, LC_flag_t *flag);
 
-/* The two functions will pop() off any nodes containing values that they
- * process, except for the node that they were psased as an input. */
-static int get_strings(LC_flag_t *flag, node_t *node, char *value);
-static int get_others(LC_flag_t *flag, node_t *node, char *value);
+/* Run the callback functions that were deferred to the end of a parse, and
+ * gather up their errors. */
+static int run_deferred(LC_parser_t *parser);
+static size_t call_run(void *context, size_t begin, size_t end);
 
-/* This function deletes the next node from the list and returns the string
- * stored in it. It returns NULL if there is no next node. */
-static char *pop_node(node_t *node);
+/* These two find value or values for a variable based on the flag that it
+ * was specified in. If a candidate value for was specified in the same
+ * argument as the flag was specified, then a pointer to the start of that
+ * value string is also passed along. */
+static int get_strings(LC_parser_t *parser, LC_flag_t *flag, char *value);
+static int get_others(LC_parser_t *parser, LC_flag_t *flag, char *value);
+
+/* Helpers for building up the arrays for a flag. The flag's variable always
+ * points at the array, and any array it was pointing at before is reused. The
+ * variable is remembered first, so that its array can be released later, and
+ * own_array() gives how many values the array has room for if it's the one we
+ * left there last time, or zero if we don't know. */
+static __LC_owned_t *own_array(LC_parser_t *parser, LC_flag_t *flag,
+	size_t *capacity, size_t size);
+
+static bool reserve_array(LC_parser_t *parser, LC_flag_t *flag, void **array,
+	size_t *capacity, size_t count, size_t size);
+
+/* Once an array is done, a new one is shrunk to fit, but one that was already
+ * ours keeps all of its room for the next parse. */
+static bool finish_array(LC_parser_t *parser, LC_flag_t *flag,
+	__LC_owned_t *owned, bool reused, void *array, size_t capacity,
+	size_t length, size_t size);
+
+/* Make sure that an array is within the bounds set for its flag. */
+static int check_length(LC_parser_t *parser, LC_flag_t *flag);
+
+/* Values for LC_OTHER_VAR flags either get converted natively (for integer
+ * and floating point formats) or through sscanf(), with a %zn on the end of
+ * the format string so that we can check that the whole value was used. */
+typedef struct {
+	bool native;
+	__LC_number_t number;
+	const char *fmt_debug;
+
+} converter_t;
+
+static bool convert(const converter_t *converter, const char *value,
+	void *dest);
+
+/* The same as convert(), for __LC_convert_all(). */
+static bool convert_any(const void *converter, const char *value,
+	void *dest);
+
+/* Convert the run of values up to the next `--' on several threads, if there
+ * are enough of them and the parser allows it. The values are appended to the
+ * array and consumed up to the first one that doesn't convert. */
+static int convert_parallel(LC_parser_t *parser, LC_flag_t *flag,
+	const converter_t *converter, void **array, size_t *capacity,
+	size_t *length);
+
+/* Convert a value that may be split up by a separator into elements from dest
+ * onwards, each stride bytes apart. Returns false if any of them doesn't
+ * convert. */
+static bool convert_list(const converter_t *converter, char *value,
+	char separator, void *dest, size_t stride);
+
+/* Check whether a value would convert for a flag, without storing it. */
+static bool converts(LC_flag_t *flag, char *value);
+
+/* Append a value to an array flag's array, split up on the flag's separator
+ * if it has one. Strings are split in place, and other values are converted
+ * straight into the array. push_values() returns LC_BAD_VAL without printing
+ * anything if the value doesn't convert. */
+static bool push_strings(LC_parser_t *parser, LC_flag_t *flag, char *value,
+	void **array, size_t *capacity, size_t *length);
+
+static int push_values(LC_parser_t *parser, LC_flag_t *flag,
+	const converter_t *converter, char *value, void **array,
+	size_t *capacity, size_t *length);
+
+/* Print an error about an invalid value and return LC_BAD_VAL. */
+static int bad_value(LC_parser_t *parser, LC_flag_t *flag, const char *value);
+
+/* This function consumes the next argument and returns it. It returns NULL if
+ * there are no arguments left. */
+static char *pop_arg(LC_parser_t *parser);
+
+/* This appends an argument to the flagless arguments. */
+static int push_flagless(LC_parser_t *parser, char *string);
 
 /* This function prints the flag in terms of its long and short values. */
-static void print_flag(LC_flag_t *flag);
+static void print_flag(LC_parser_t *parser, LC_flag_t *flag);
+
+/* Point the global parser at the global variables before a call, and copy
+ * its results back out afterwards. */
+static int global_init(void);
+static int global_setup(void);
+static int global_finish(int ret);
 
-/* Our main function. */
+/* Our main function, which runs the global parser over the global
+ * variables. */
 int LC_read(int argc, char **argv) {
 	/* Get our program name out. */
 	LC_prog_name = argv[0];
 
+	int ret = global_setup();
+	if(ret != LC_OK) return ret;
+
+	return global_finish(LC_parse(&global_parser, argc, argv));
+}
+
+int LC_read_string(char *string) {
+	int ret = global_setup();
+	if(ret != LC_OK) return ret;
+
+	return global_finish(LC_parse_string(&global_parser, string));
+}
+
+int LC_read_fd(char *prog_name, int fd, char delimiter) {
+	int ret = global_setup();
+	if(ret != LC_OK) return ret;
+
+	return global_finish(LC_parse_fd(&global_parser, prog_name, fd,
+		delimiter
+	));
+}
+
+int LC_set_allocator(const LC_allocator_t *allocator) {
+	int ret = global_init();
+	if(ret != LC_OK) return ret;
+
+	LC_parser_set_allocator(&global_parser, allocator);
+
+	LC_flagless_args = NULL;
+	LC_flagless_args_length = 0;
+	return LC_OK;
+}
+
+void LC_free(void) {
+	if(!global_parser.state) return;
+
+	LC_parser_release(&global_parser);
+
+	LC_flagless_args = NULL;
+	LC_flagless_args_length = 0;
+	LC_function_errors = NULL;
+	LC_function_errors_length = 0;
+}
+
+static int global_init(void) {
+	if(global_parser.state) return LC_OK;
+	return LC_parser_init(&global_parser, NULL, 0);
+}
+
+static int global_setup(void) {
+	LC_err_index = 0;
+	LC_err_flag = NULL;
+
 	/* Bail if the LC_flags array is not properly set up. */
 	if(!LC_flags) return LC_NO_ARGS;
 
-	/* If there's any previously allocated array of flagless arguments,
-	 * clear it first to avoid memory leaks. */
-	if(LC_flagless_args) {
-		free(LC_flagless_args);
-		LC_flagless_args = NULL;
+	int ret = global_init();
+	if(ret != LC_OK) return ret;
+
+	global_parser.flags = LC_flags;
+	global_parser.flags_length = LC_flags_length;
+	global_parser.response_depth = LC_response_depth;
+	global_parser.convert_threads = LC_convert_threads;
+	global_parser.convert_threshold = LC_convert_threshold;
+	global_parser.parse_threads = LC_parse_threads;
+	global_parser.defer_functions = LC_defer_functions;
+	global_parser.function_threads = LC_function_threads;
+	global_parser.flagless_function = LC_flagless_function;
+	global_parser.flagless_context = LC_flagless_context;
+	return LC_OK;
+}
+
+static int global_finish(int ret) {
+	/* Copy the results back out to the global variables. */
+	LC_flagless_args = global_parser.flagless_args;
+	LC_flagless_args_length = global_parser.flagless_args_length;
+	LC_prog_name = global_parser.prog_name;
+
+	if(ret == LC_FUNC_ERR) {
+		LC_err_function = (int (*)()) global_parser.err_function;
+		LC_function_errno = global_parser.function_errno;
 	}
 
-	LC_flagless_args_length = 0;
+	if(ret != LC_OK) {
+		LC_err_index = global_parser.err_index;
+		LC_err_flag = global_parser.err_flag;
+	}
+
+	LC_function_errors = global_parser.function_errors;
+	LC_function_errors_length = global_parser.function_errors_length;
+
+	/* LC_read() has always marked the flags it has seen as read-only, so
+	 * that later calls can't set them again. */
+	__LC_state_t *state = global_parser.state;
+
+	if(state -> index.flags == LC_flags) {
+		for(size_t i = 0; i < LC_flags_length; i++) {
+			LC_flags[i].readonly = state -> seen[i];
+		}
+	}
+
+	return ret;
+}
+
+int LC_parser_init(LC_parser_t *parser, LC_flag_t *flags,
+	size_t flags_length)
+{
+	memset(parser, 0, sizeof(LC_parser_t));
+
+	parser -> flags = flags;
+	parser -> flags_length = flags_length;
+	parser -> convert_threshold = CONVERT_THRESHOLD;
+
+	/* The state itself lives as long as the parser does, so it always
+	 * comes from malloc(). */
+	__LC_state_t *state = calloc(1, sizeof(__LC_state_t));
+	if(!state) return LC_MALLOC_ERR;
+
+	state -> allocator = __LC_default_allocator;
+	state -> expansion.allocator = &state -> allocator;
+
+	parser -> state = state;
+	return LC_OK;
+}
+
+void LC_parser_set_allocator(LC_parser_t *parser,
+	const LC_allocator_t *allocator)
+{
+	LC_parser_release(parser);
+
+	parser -> state -> allocator = allocator? *allocator:
+		__LC_default_allocator;
+}
+
+/* Release the buffers that came from the parser's allocator, apart from the
+ * arrays in the flags' variables. */
+static void release_buffers(LC_parser_t *parser) {
+	__LC_state_t *state = parser -> state;
+	const LC_allocator_t *allocator = &state -> allocator;
+
+	__LC_expansion_free(&state -> expansion);
+
+	__LC_free(allocator, state -> tokens);
+	state -> tokens = NULL;
+	state -> tokens_capacity = 0;
 
-	/* Push the arguments into the list; the root node has argv[0]. */
-	node_t *current = &root;
-	for(int i = 0; i < argc; i++) {
-		current -> string = argv[i];
+	__LC_free(allocator, state -> lookups);
+	state -> lookups = NULL;
+	state -> lookups_capacity = 0;
+	state -> looked_up = false;
 
-		// Don't initialise node -> next for the last node.
-		if(i == argc - 1) break;
+	__LC_free(allocator, state -> owned);
+	state -> owned = NULL;
+	state -> owned_length = state -> owned_capacity = 0;
 
-		/* Allocate the memory for the next argument. */
-		current -> next = malloc(sizeof(node_t));
-		if(!current -> next) return LC_MALLOC_ERR;
+	__LC_free(allocator, state -> pending);
+	state -> pending = NULL;
+	state -> pending_length = state -> pending_capacity = 0;
+	state -> feeding = false;
 
-		current -> next -> prev = current;
-		current -> next -> next = NULL;
-		current = current -> next;
+	if(state -> owned_flags) {
+		memset(state -> owned_flags, 0,
+			state -> index.flags_length * sizeof(size_t)
+		);
 	}
 
-	LC_flagless_args_length = argc - 1; // Not including the root node.
+	__LC_free(allocator, parser -> flagless_args);
+	parser -> flagless_args = NULL;
+	parser -> flagless_args_length = 0;
+	state -> flagless_args_capacity = 0;
+
+	__LC_free(allocator, parser -> function_errors);
+	parser -> function_errors = NULL;
+	parser -> function_errors_length = 0;
+	state -> function_errors_capacity = 0;
 
-	/* Iterate through the flags, process them, and delete them if
-	 * appropriate. */
+	__LC_blocks_free(parser);
+	__LC_free(allocator, state -> blocks);
+	state -> blocks = NULL;
+	state -> blocks_capacity = 0;
+}
 
-	/* We always look at the node after the node in the iterator. */
-	for(node_t *i = &root; i -> next;) {
-		/* A `-' by itself is usually used to stand in for stdin or
-		 * stdout. */
-		if(!strcmp(i -> next -> string, "-")) i = i -> next;
+void LC_parser_release(LC_parser_t *parser) {
+	__LC_state_t *state = parser -> state;
+	if(!state) return;
 
-		/* If there's a `--' that's just sitting in the list marks the
-		 * end of the flags on the command line. */
-		else if(!strcmp(i -> next -> string, "--")) {
-			pop_node(i);
-			break;
+	const LC_allocator_t *allocator = &state -> allocator;
+
+	/* Point the variables back at nothing. */
+	for(size_t i = 0; i < state -> owned_length; i++) {
+		__LC_free(allocator, *state -> owned[i].array);
+		*state -> owned[i].array = NULL;
+		*state -> owned[i].length = 0;
+	}
+
+	release_buffers(parser);
+
+	/* Nothing from the allocator is in use any more. */
+	if(allocator -> reset) allocator -> reset(allocator -> context);
+}
+
+void LC_parser_free(LC_parser_t *parser) {
+	__LC_state_t *state = parser -> state;
+	if(!state) return;
+
+	release_buffers(parser);
+
+	__LC_index_free(&state -> index);
+	free(state -> seen);
+	free(state -> owned_flags);
+	free(state -> calls);
+	free(state -> queue);
+	free(state -> independent);
+	free(state);
+
+	parser -> state = NULL;
+}
+
+/* Get a parser ready to walk a new set of arguments. */
+static int begin_parse(LC_parser_t *parser, char *prog_name) {
+	__LC_state_t *state = parser -> state;
+
+	state -> arg = 0;
+	state -> flag = NULL;
+
+	/* Get our program name out. */
+	parser -> prog_name = prog_name;
+
+	/* Bail if the flags array is not properly set up. */
+	if(!parser -> flags) return LC_NO_ARGS;
+
+	/* (Re)build the flag lookup index if we haven't seen this array. */
+	if(state -> index.flags != parser -> flags
+		|| state -> index.flags_length != parser -> flags_length)
+	{
+		size_t bytes = (parser -> flags_length + 1) * sizeof(bool);
+
+		bool *seen = realloc(state -> seen, bytes);
+		if(!seen) return LC_MALLOC_ERR;
+		state -> seen = seen;
+
+		size_t length = parser -> flags_length + 1;
+
+		/* The variables in the owned arrays belong to the old flags,
+		 * which may not be around any more, so their arrays are left
+		 * to the caller rather than released through them later. */
+		state -> owned_length = 0;
+
+		size_t *owned_flags = realloc(state -> owned_flags,
+			length * sizeof(size_t)
+		);
+
+		if(!owned_flags) return LC_MALLOC_ERR;
+		state -> owned_flags = owned_flags;
+
+		memset(state -> owned_flags, 0, length * sizeof(size_t));
+
+		void *calls = realloc(state -> calls,
+			length * sizeof(*state -> calls)
+		);
+
+		if(!calls) return LC_MALLOC_ERR;
+		state -> calls = calls;
+
+		size_t *queue = realloc(state -> queue,
+			length * sizeof(size_t)
+		);
+
+		if(!queue) return LC_MALLOC_ERR;
+		state -> queue = queue;
+
+		size_t *independent = realloc(state -> independent,
+			length * sizeof(size_t)
+		);
+
+		if(!independent) return LC_MALLOC_ERR;
+		state -> independent = independent;
+
+		int ret = __LC_index_build(&state -> index, parser -> flags,
+			parser -> flags_length, parser -> prog_name
+		);
+
+		if(ret != LC_OK) return ret;
+	}
+
+	/* Flags that are already read-only count as having been seen. */
+	for(size_t i = 0; i < parser -> flags_length; i++) {
+		state -> seen[i] = parser -> flags[i].readonly;
+		state -> calls[i].queued = false;
+	}
+
+	state -> queue_length = 0;
+
+	parser -> function_errors_length = 0;
+
+	/* Any flagless arguments from a previous call are forgotten, but the
+	 * memory for them is reused. */
+	parser -> flagless_args_length = 0;
+	state -> end_of_flags = false;
+	state -> looked_up = false;
+
+	return LC_OK;
+}
+
+int LC_parse(LC_parser_t *parser, int argc, char **argv) {
+	return __LC_stopped(parser, parse_args(parser, argc, argv));
+}
+
+int __LC_stopped(LC_parser_t *parser, int ret) {
+	if(ret != LC_OK) {
+		parser -> err_index = parser -> state -> arg;
+		parser -> err_flag = parser -> state -> flag;
+	}
+
+	return ret;
+}
+
+static int parse_args(LC_parser_t *parser, int argc, char **argv) {
+	__LC_state_t *state = parser -> state;
+
+	/* This abandons anything that was being fed in. */
+	state -> feeding = false;
+
+	int ret = begin_parse(parser, argv[0]);
+	if(ret != LC_OK) return ret;
+
+	/* Start walking the arguments after argv[0], expanding any response
+	 * files first if that has been turned on. */
+	state -> args = argv;
+	state -> args_length = argc;
+	state -> next_arg = 1;
+
+	if(parser -> response_depth) {
+		int ret = __LC_expand(&state -> expansion, argc, argv,
+			parser -> response_depth, parser -> prog_name
+		);
+
+		if(ret != LC_OK) return ret;
+
+		state -> args = state -> expansion.argv;
+		state -> args_length = state -> expansion.argc;
+	}
+
+	else __LC_expansion_clear(&state -> expansion);
+
+	ret = look_up_args(parser);
+	if(ret != LC_OK) return ret;
+
+	while(state -> next_arg < state -> args_length) {
+		int ret = parse_arg(parser);
+		if(ret != LC_OK) return ret;
+
+		if(state -> end_of_flags) break;
+	}
+
+	/* The remaining arguments are flagless arguments. */
+	while(state -> next_arg < state -> args_length) {
+		int ret = push_flagless(parser,
+			state -> args[state -> next_arg++]
+		);
+
+		if(ret != LC_OK) return ret;
+	}
+
+	return run_deferred(parser);
+}
+
+int LC_parse_string(LC_parser_t *parser, char *string) {
+	__LC_state_t *state = parser -> state;
+
+	/* Split the string up in place. The null byte at the end of the
+	 * string leaves room for the last token's null byte. */
+	char *cursor = string, *end = string + strlen(string);
+	size_t length = 0;
+
+	for(char *token; (token = __LC_next_token(&cursor, end));) {
+		/* Keep room for the NULL that ends an argv[], so that argv[0]
+		 * is NULL if the string was empty. */
+		if(length + 1 >= state -> tokens_capacity) {
+			size_t capacity = state -> tokens_capacity?
+				state -> tokens_capacity * 2: 16;
+
+			char **tokens = __LC_realloc(&state -> allocator,
+				state -> tokens, capacity * sizeof(char *)
+			);
+
+			if(!tokens) return LC_MALLOC_ERR;
+
+			state -> tokens = tokens;
+			state -> tokens_capacity = capacity;
 		}
 
-		/* One hyphen for short flags, two for long flags. */
-		else if(i -> next -> string[0] == '-') {
-			if(i -> next -> string[1] == '-') {
-				int ret = evaluate_lflag(i -> next);
-				if(ret != LC_OK) return ret;
-			}
+		state -> tokens[length++] = token;
+	}
 
-			else {
-				int ret = evaluate_sflags(i -> next);
-				if(ret != LC_OK) return ret;
-			}
+	/* An empty string parses as an empty command line. */
+	if(!state -> tokens) {
+		static char *empty[] = {NULL};
+		return LC_parse(parser, 0, empty);
+	}
+
+	state -> tokens[length] = NULL;
+	return LC_parse(parser, (int) length, state -> tokens);
+}
+
+static int look_up_args(LC_parser_t *parser) {
+	__LC_state_t *state = parser -> state;
+	size_t count = state -> args_length, threads = 1;
+
+	if(parser -> parse_threads > 1 && count >= PARSE_THRESHOLD) {
+		threads = __LC_threads(parser -> parse_threads);
+	}
 
-			pop_node(i);
+	size_t capacity = threads > 1? count: LOOK_UP_WINDOW;
+
+	if(capacity > state -> lookups_capacity) {
+		__LC_lookup_t *lookups = __LC_realloc(&state -> allocator,
+			state -> lookups, capacity * sizeof(__LC_lookup_t)
+		);
+
+		if(!lookups) return LC_MALLOC_ERR;
+
+		state -> lookups = lookups;
+		state -> lookups_capacity = capacity;
+	}
+
+	/* Nothing has been looked up yet on the calling thread, so the first
+	 * flag that the walk gets to sweeps the first window. */
+	state -> looked_begin = state -> looked_end = 0;
+	state -> looked_up = true;
+
+	if(threads > 1) {
+		__LC_parallel(look_up_run, parser, count, threads);
+		state -> looked_end = count;
+	}
+
+	return LC_OK;
+}
+
+static void look_up_window(LC_parser_t *parser, size_t arg) {
+	__LC_state_t *state = parser -> state;
+	size_t end = state -> args_length - arg < LOOK_UP_WINDOW?
+		state -> args_length: arg + LOOK_UP_WINDOW;
+
+	state -> looked_begin = arg;
+	state -> looked_end = end;
+	look_up_run(parser, arg, end);
+}
+
+static size_t look_up_run(void *context, size_t begin, size_t end) {
+	LC_parser_t *parser = context;
+	__LC_state_t *state = parser -> state;
+
+	/* Nothing is written to the arguments or the index while this runs,
+	 * so the threads don't need to coordinate with each other at all.
+	 * argv[0] is the program name, and isn't looked at. */
+	for(size_t i = begin? begin: 1; i < end; i++) {
+		char *string = state -> args[i];
+		__LC_lookup_t *lookup =
+			&state -> lookups[i - state -> looked_begin];
+
+		lookup -> flag = NULL;
+
+		if(string[0] != '-') {
+			lookup -> class.kind = __LC_FLAGLESS;
 			continue;
 		}
 
-		/* Flagless argument. */
-		i = i -> next;
+		__LC_classify(string, &lookup -> class);
+		if(lookup -> class.kind != __LC_LONG_FLAG) continue;
+
+		size_t length = lookup -> class.equals?
+			lookup -> class.equals: lookup -> class.length;
+
+		lookup -> flag = __LC_index_lflag(&state -> index,
+			&string[2], length - 2
+		);
+	}
+
+	return end;
+}
+
+static int parse_arg(LC_parser_t *parser) {
+	__LC_state_t *state = parser -> state;
+	size_t arg = state -> next_arg++;
+	char *string = state -> args[arg];
+
+	state -> arg = arg;
+	state -> flag = NULL;
+
+	/* Most arguments don't start with a `-', and so aren't flags. They
+	 * don't need classifying any further. */
+	if(state -> end_of_flags || string[0] != '-') {
+		return push_flagless(parser, string);
+	}
+
+	__LC_class_t class;
+	LC_flag_t *flag = NULL;
+
+	if(state -> looked_up) {
+		if(arg >= state -> looked_end) look_up_window(parser, arg);
+
+		size_t i = arg - state -> looked_begin;
+		class = state -> lookups[i].class;
+		flag = state -> lookups[i].flag;
+	}
+
+	else __LC_classify(string, &class);
+
+	switch(class.kind) {
+	/* A `--' marks the end of the flags on the command line. */
+	case __LC_DOUBLE_DASH:
+		state -> end_of_flags = true;
+		return LC_OK;
+
+	/* One hyphen for short flags, two for long flags. */
+	case __LC_SHORT_FLAGS:
+		return evaluate_sflags(parser, string, class.length);
+
+	case __LC_LONG_FLAG:
+		return evaluate_lflag(parser, string, class.length,
+			class.equals, flag
+		);
+
+	/* A `-' by itself is usually used to stand in for stdin or
+	 * stdout. */
+	default:
+		return push_flagless(parser, string);
+	}
+}
+
+int LC_feed(LC_parser_t *parser, char *arg) {
+	__LC_state_t *state = parser -> state;
+
+	/* The first argument fed in is the program name. */
+	if(!state -> feeding) {
+		state -> feeding = true;
+		state -> pending_length = 0;
+		state -> feed_scanned = 0;
+		state -> fed = 1;
+
+		__LC_expansion_clear(&state -> expansion);
+
+		return state -> feed_ret = __LC_stopped(parser,
+			begin_parse(parser, arg)
+		);
+	}
+
+	/* Once something has gone wrong, there's no point carrying on. */
+	if(state -> feed_ret != LC_OK) return state -> feed_ret;
+
+	if(state -> pending_length == state -> pending_capacity) {
+		size_t capacity = state -> pending_capacity?
+			state -> pending_capacity * 2: 16;
+
+		char **pending = __LC_realloc(&state -> allocator,
+			state -> pending, capacity * sizeof(char *)
+		);
+
+		if(!pending) {
+			return state -> feed_ret = __LC_stopped(parser,
+				LC_MALLOC_ERR
+			);
+		}
+
+		state -> pending = pending;
+		state -> pending_capacity = capacity;
+	}
+
+	state -> pending[state -> pending_length++] = arg;
+
+	return state -> feed_ret = __LC_stopped(parser,
+		drain_pending(parser, false)
+	);
+}
+
+int LC_feed_args(LC_parser_t *parser, size_t count, char **args) {
+	for(size_t i = 0; i < count; i++) {
+		int ret = LC_feed(parser, args[i]);
+		if(ret != LC_OK) return ret;
 	}
 
-	/* The remaining nodes are flagless arguments. */
+	return LC_OK;
+}
+
+int LC_finish(LC_parser_t *parser) {
+	__LC_state_t *state = parser -> state;
+
+	/* Finishing without feeding anything is an empty command line. */
+	if(!state -> feeding) {
+		return __LC_stopped(parser, begin_parse(parser, NULL));
+	}
+
+	/* Whatever is still pending runs up to the end of the arguments. */
+	int ret = state -> feed_ret;
+	if(ret == LC_OK) ret = drain_pending(parser, true);
+	if(ret == LC_OK) ret = run_deferred(parser);
+
+	state -> feeding = false;
+	state -> pending_length = 0;
+	return __LC_stopped(parser, ret);
+}
 
-	/* Calling malloc() with a zero size is not portable. */
-	LC_flagless_args = LC_flagless_args_length?
-		malloc(sizeof(char *) * LC_flagless_args_length) :
-		malloc(sizeof(char *));
+static int drain_pending(LC_parser_t *parser, bool finish) {
+	__LC_state_t *state = parser -> state;
 
-	if(!LC_flagless_args) return LC_MALLOC_ERR;
+	while(state -> pending_length) {
+		if(!finish && !pending_ready(parser)) return LC_OK;
 
-	/* Copy the flagless arguments over. */
-	for(size_t i = 0; i < LC_flagless_args_length; i++) {
-		LC_flagless_args[i] = pop_node(&root);
-		LC_flagless_args_length++; // pop_node() decrements this value.
+		/* Walk the pending arguments as if they were all there is, and
+		 * then drop the ones that were used. */
+		state -> args = state -> pending;
+		state -> args_length = state -> pending_length;
+		state -> next_arg = 0;
+
+		int ret = parse_arg(parser);
+
+		/* Count the arguments from the start of everything that was
+		 * fed in, rather than from the start of the pending ones. */
+		state -> arg += state -> fed;
+		state -> fed += state -> next_arg;
+
+		state -> pending_length -= state -> next_arg;
+		memmove(state -> pending, &state -> pending[state -> next_arg],
+			state -> pending_length * sizeof(char *)
+		);
+
+		state -> feed_scanned = 0;
+		if(ret != LC_OK) return ret;
 	}
 
-	/* Return out successfully. */
 	return LC_OK;
 }
 
-static int evaluate_lflag(node_t *node) {
+static bool pending_ready(LC_parser_t *parser) {
+	__LC_state_t *state = parser -> state;
+	char *string = state -> pending[0];
+
+	/* Flagless arguments and `--' stand by themselves. */
+	if(state -> end_of_flags || string[0] != '-' || !string[1]) return true;
+	if(string[1] == '-' && !string[2]) return true;
+
+	/* Find the flag that takes values, if there is one. */
+	LC_flag_t *flag = NULL;
+	bool has_value = false;
+
+	if(string[1] == '-') {
+		char *equals_ch = strchr(string, '=');
+		size_t length = equals_ch? (size_t) (equals_ch - string) - 2:
+			strlen(&string[2]);
+
+		flag = __LC_index_lflag(&state -> index, &string[2], length);
+		has_value = equals_ch;
+	}
+
+	else for(char *ch = &string[1]; *ch; ch++) {
+		flag = __LC_index_sflag(&state -> index, *ch);
+		if(!flag) return true;
+
+		if(flag -> var_ptr && flag -> var_type != LC_BOOL_VAR) {
+			has_value = ch[1];
+			break;
+		}
+	}
+
+	/* Unknown flags and flags that don't take values can go right away,
+	 * and so can anything that's about to error out. */
+	if(!flag || !flag -> var_ptr || flag -> var_type == LC_BOOL_VAR) {
+		return true;
+	}
+
+	if(flag -> var_type != LC_STRING_VAR) {
+		if(flag -> var_type != LC_OTHER_VAR) return true;
+		if(!flag -> fmt_string) return true;
+	}
+
+	/* A single value is either in the flag's argument or the next. */
+	if(!flag -> arr_length) return has_value || state -> pending_length > 1;
+
+	/* An array runs up to the next `--', or the first value that doesn't
+	 * convert for other variables. We remember how far we have looked, so
+	 * that each argument is only looked at once. */
+	size_t i = state -> feed_scanned? state -> feed_scanned: 1;
+
+	for(; i < state -> pending_length; i++) {
+		char *value = state -> pending[i];
+
+		if(value[0] == '-' && value[1] == '-' && !value[2]) return true;
+		if(flag -> var_type == LC_OTHER_VAR && !converts(flag, value)) {
+			return true;
+		}
+	}
+
+	state -> feed_scanned = i;
+	return false;
+}
+
+static bool converts(LC_flag_t *flag, char *value) {
+	converter_t converter;
+	converter.native = __LC_number_format(flag -> fmt_string,
+		&converter.number
+	);
+
+	size_t fmt_len = converter.native? 0: strlen(flag -> fmt_string);
+	char fmt_debug[fmt_len + 4];
+
+	if(!converter.native) {
+		memcpy(fmt_debug, flag -> fmt_string, fmt_len);
+		memcpy(&fmt_debug[fmt_len], "%zn", 4);
+	}
+
+	converter.fmt_debug = fmt_debug;
+
+	/* Convert into some scratch space rather than the variable. */
+	typedef union { long double ld; long long ll; void *ptr; } align_t;
+	align_t scratch[flag -> var_length / sizeof(align_t) + 1];
+
+	return convert_list(&converter, value, flag -> separator, scratch, 0);
+}
+
+static int evaluate_lflag(LC_parser_t *parser, char *string, size_t length,
+	size_t equals, LC_flag_t *flag)
+{
 	/* Processing a long flag. */
-	processing_lflag = true;
+	parser -> state -> processing_lflag = true;
 
 	/* Change the first equal character in the string since to a null byte
 	 * since it splits the flag from its (first) value. */
-	char *equals_ch = strchr(node -> string, '=');
+	char *equals_ch = equals? &string[equals]: NULL;
 	if(equals_ch) *equals_ch = 0;
 
 	/* Split the strings and store NULLs if there's no data. */
-	char *lflag = &node -> string[2]; // Skip the '--'.
+	char *lflag = &string[2]; // Skip the '--'.
 	char *value = equals_ch? equals_ch + 1: NULL;
 
-	/* See if we can find the flag this corresponds to. */
-	LC_flag_t *flag = find_flag(lflag, 0);
+	/* See if we can find the flag this corresponds to, unless it has been
+	 * looked up already. */
+	if(!flag) {
+		flag = __LC_index_lflag(&parser -> state -> index, lflag,
+			(equals? equals: length) - 2
+		);
+	}
 
 	if(!flag) {
 		fprintf(stderr, "%s: error: unknown flag '--%s'.\n",
-			LC_prog_name, lflag
+			parser -> prog_name, lflag
 		);
 
 		return LC_BAD_FLAG;
 	}
 
-	/* Make sure that the flag isn't being set for the second time. */
-	if(flag -> readonly) {
-		fprintf(stderr, "%s: error: the flag '--%s' has been set "
-			"multiple times.\n", LC_prog_name, lflag
-		);
+	parser -> state -> flag = flag;
 
-		return LC_VAR_RESET;
-	}
-
-	flag -> readonly = true;
+	/* Make sure that the flag isn't being set for the second time. */
+	int ret = mark_seen(parser, flag);
+	if(ret != LC_OK) return ret;
 
 	/* If there's no variable but there's a value specified, error out. */
 	if(!flag -> var_ptr && value) {
 		fprintf(stderr, "%s: error: the flag `--%s' does not take any"
-			"values.\n", LC_prog_name, lflag
+			"values.\n", parser -> prog_name, lflag
 		);
 
 		return LC_BAD_VAL;
@@ -213,11 +967,9 @@ static int evaluate_lflag(node_t *node) {
 	/* If there's no variable to be dealt with now, skip this section. */
 	if(flag -> var_ptr) {
 		/* Process the variable. */
-		int ret = 0; // Needs to be declared outside of the switch.
-
 		switch(flag -> var_type) {
 		case LC_STRING_VAR:
-			ret = get_strings(flag, node, value);
+			ret = get_strings(parser, flag, value);
 			if(ret != LC_OK) return ret;
 			break;
 
@@ -226,7 +978,7 @@ static int evaluate_lflag(node_t *node) {
 			break;
 
 		case LC_OTHER_VAR:
-			ret = get_others(flag, node, value);
+			ret = get_others(parser, flag, value);
 			if(ret != LC_OK) return ret;
 			break;
 
@@ -236,30 +988,20 @@ static int evaluate_lflag(node_t *node) {
 	}
 
 	/* Execute the supplied function if there is one. */
-	if(flag -> function) {
-		int ret = flag -> function(flag);
-
-		if(ret != LC_OK) {
-			/* Save the error information. */
-			LC_err_function = flag -> function;
-			LC_function_errno = ret;
-			return LC_FUNC_ERR;
-		}
-	}
-
-	return LC_OK;
+	return run_function(parser, flag);
 }
 
-static int evaluate_sflags(node_t *node) {
-	/* Processing a long flag. */
-	processing_lflag = false;
+static int evaluate_sflags(LC_parser_t *parser, char *string, size_t length)
+{
+	/* Processing a short flag. */
+	parser -> state -> processing_lflag = false;
 
 	/* As long as we have characters to process, loop over the flags.
 	 * Also, Ignore the leading `-'. */
-	for(size_t i = 1; node -> string[i]; i++) {
+	for(size_t i = 1; i < length; i++) {
 		/* If the string has no length, send a NULL instead. */
-		int ret = evaluate_sflag(node, node -> string[i],
-			node -> string[i + 1]? &node -> string[i + 1]: NULL
+		int ret = evaluate_sflag(parser, string[i],
+			i + 1 < length? &string[i + 1]: NULL
 		);
 
 		/* Using the value means all the other characters have been
@@ -271,37 +1013,30 @@ static int evaluate_sflags(node_t *node) {
 	return LC_OK;
 }
 
-static int evaluate_sflag(node_t *node, char sflag, char *value) {
+static int evaluate_sflag(LC_parser_t *parser, char sflag, char *value) {
 	/* See if we can find the flag this corresponds to. */
-	LC_flag_t *flag = find_flag(NULL, sflag);
+	LC_flag_t *flag = __LC_index_sflag(&parser -> state -> index, sflag);
 
 	if(!flag) {
 		fprintf(stderr, "%s: error: unknown flag '-%c'.\n",
-			LC_prog_name, sflag
+			parser -> prog_name, sflag
 		);
 
 		return LC_BAD_FLAG;
 	}
 
-	/* Make sure that the flag isn't being set for the second time. */
-	if(flag -> readonly) {
-		fprintf(stderr, "%s: error: the flag '-%c' has been set "
-			"multiple times.\n", LC_prog_name, sflag
-		);
-
-		return LC_VAR_RESET;
-	}
+	parser -> state -> flag = flag;
 
-	flag -> readonly = true;
+	/* Make sure that the flag isn't being set for the second time. */
+	int ret = mark_seen(parser, flag);
+	if(ret != LC_OK) return ret;
 
 	/* If there's no variable to be dealt with now, skip this section. */
 	if(flag -> var_ptr) {
 		/* Process the variable. */
-		int ret = 0; // Needs to be declared outside of the switch.
-
 		switch(flag -> var_type) {
 		case LC_STRING_VAR:
-			ret = get_strings(flag, node, value);
+			ret = get_strings(parser, flag, value);
 			if(ret != LC_OK) return ret;
 			break;
 
@@ -310,7 +1045,7 @@ static int evaluate_sflag(node_t *node, char sflag, char *value) {
 			break;
 
 		case LC_OTHER_VAR:
-			ret = get_others(flag, node, value);
+			ret = get_others(parser, flag, value);
 			if(ret != LC_OK) return ret;
 			break;
 
@@ -320,16 +1055,8 @@ static int evaluate_sflag(node_t *node, char sflag, char *value) {
 	}
 
 	/* Execute the supplied function if there is one. */
-	if(flag -> function) {
-		int ret = flag -> function(flag);
-
-		/* Save and bail on errors. */
-		if(ret != LC_OK) {
-			LC_err_function = flag -> function;
-			LC_function_errno = ret;
-			return LC_FUNC_ERR;
-		}
-	}
+	ret = run_function(parser, flag);
+	if(ret != LC_OK) return ret;
 
 	/* Bool setting doesn't take a value on the command line, but other
 	 * types of variables do. */
@@ -337,257 +1064,447 @@ static int evaluate_sflag(node_t *node, char sflag, char *value) {
 		LC_OK_VALUE_USED: LC_OK;
 }
 
-static LC_flag_t *find_flag(const char *lflag, char sflag) {
-	/* Only check long flags if the short flag doesn't match. */
-	for(size_t i = 0; i < LC_flags_length; i++) {
-		if(sflag == LC_flags[i].short_flag) return &LC_flags[i];
+static int mark_seen(LC_parser_t *parser, LC_flag_t *flag) {
+	bool *seen = &parser -> state -> seen[flag - parser -> flags];
 
-		if(!lflag) continue; // Don't pass null pointers to strcmp.
-		if(!LC_flags[i].long_flag) continue;
+	if(*seen) {
+		fprintf(stderr, "%s: error: the flag ", parser -> prog_name);
+		print_flag(parser, flag);
+		fprintf(stderr, " has been set multiple times.\n");
 
-		if(!strcmp(lflag, LC_flags[i].long_flag)) return &LC_flags[i];
+		return LC_VAR_RESET;
 	}
 
-	/* Return NULL if we found nothing. */
-	return NULL;
+	*seen = true;
+	return LC_OK;
 }
 
-static int get_strings(LC_flag_t *flag, node_t *node, char *value) {
-	/* A single string with a given value can be set easily. */
-	if(!flag -> arr_length && value) {
-		*(char **) flag -> var_ptr = value;
+static int run_function(LC_parser_t *parser, LC_flag_t *flag) {
+	if(!flag -> function) return LC_OK;
+
+	/* Deferred callback functions run in the order of the command line,
+	 * the same as they would have otherwise. */
+	if(parser -> defer_functions) {
+		__LC_state_t *state = parser -> state;
+		size_t index = flag - parser -> flags;
+
+		state -> calls[index].queued = true;
+		state -> queue[state -> queue_length++] = index;
 		return LC_OK;
 	}
 
-	/* If it's just a single variable, get the value from the next node. */
-	if(!flag -> arr_length && !value) {
-		/* Get the value and remove the node. */
-		*(char **) flag -> var_ptr = pop_node(node);
+	int ret = flag -> function(flag);
 
-		if(!*(char **) flag -> var_ptr) {
-			fprintf(stderr, "%s: error: the flag ", LC_prog_name);
-			print_flag(flag);
-			fprintf(stderr, " needs an additional argument.\n");
+	/* Save the error information. */
+	if(ret != LC_OK) {
+		parser -> err_function = flag -> function;
+		parser -> function_errno = ret;
+		return LC_FUNC_ERR;
+	}
 
-			return LC_NO_VAL;
-		}
+	return LC_OK;
+}
 
-		return LC_OK;
-	}
+static int run_deferred(LC_parser_t *parser) {
+	__LC_state_t *state = parser -> state;
+	if(!parser -> defer_functions) return LC_OK;
 
-	/* Since we have an array, check how many values we have in total. */
-	*(flag -> arr_length) = value? 1: 0;
+	/* The callback functions for independent flags are handed out to the
+	 * other threads, while this thread runs the rest of them in order. */
+	state -> independent_length = 0;
 
-	for(node_t *i = node -> next; i; i = i -> next) {
-		/* Check that the value isn't `--'. */
-		if(!strcmp(i -> string, "--")) {
-			/* Get rid of the `--', which marks the end of the
-			 * array. Break out. */
-			pop_node(i -> prev);
-			break;
-		}
+	if(parser -> function_threads > 1) {
+		for(size_t i = 0; i < state -> queue_length; i++) {
+			size_t index = state -> queue[i];
+			if(!parser -> flags[index].independent) continue;
 
-		++*(flag -> arr_length);
+			state -> independent[state -> independent_length++] =
+				index;
+		}
 	}
 
-	/* If the array has already been allocated, de-allocate it. */
-	if(*(char ***) flag -> var_ptr) free(*(char ***) flag -> var_ptr);
+	/* These mostly wait on files and the like, so there can be more
+	 * threads than there are processors. */
+	__LC_parallel(call_run, parser, state -> independent_length + 1,
+		parser -> function_threads
+	);
 
-	/* Allocate the memory for the array. We cannot portably call malloc()
-	 * with a size of zero. (This type is cursed.) */
-	*(char ***) flag -> var_ptr = *(flag -> arr_length)?
-		malloc(*(flag -> arr_length) * sizeof(char *)) :
-		malloc(sizeof(char *));
+	/* Gather up the errors in the order of the command line. */
+	for(size_t j = 0; j < state -> queue_length; j++) {
+		size_t i = state -> queue[j];
 
-	if(!*(char ***) flag -> var_ptr) return LC_MALLOC_ERR;
+		int ret = state -> calls[i].ret;
+		if(ret == LC_FUNCTION_OK) continue;
 
-	/* Copy or move the values over. */
-	if(value) (*(char ***) flag -> var_ptr)[0] = value;
+		if(parser -> function_errors_length
+			== state -> function_errors_capacity)
+		{
+			size_t capacity = state -> function_errors_capacity?
+				state -> function_errors_capacity * 2: 4;
 
-	for(size_t i = value? 1: 0; i < *(flag -> arr_length); i++) {
-		(*(char ***) flag -> var_ptr)[i] = pop_node(node);
-	}
+			LC_function_error_t *errors = __LC_realloc(
+				&state -> allocator, parser -> function_errors,
+				capacity * sizeof(LC_function_error_t)
+			);
 
-	/* Let's go ahead and verify that the array length is appropriate. */
-	if(*(flag -> arr_length) < flag -> min_arr_length) {
-		fprintf(stderr, "%s: error: the flag ", LC_prog_name);
-		print_flag(flag);
-		fprintf(stderr, " has too few arguments provided.\n");
+			if(!errors) return LC_MALLOC_ERR;
 
-		return LC_LESS_VALS;
+			parser -> function_errors = errors;
+			state -> function_errors_capacity = capacity;
+		}
+
+		size_t length = parser -> function_errors_length++;
+		parser -> function_errors[length].flag = &parser -> flags[i];
+		parser -> function_errors[length].function_errno = ret;
 	}
 
-	if(*(flag -> arr_length) > flag -> max_arr_length) {
-		fprintf(stderr, "%s: error: the flag ", LC_prog_name);
-		print_flag(flag);
-		fprintf(stderr, " has too many arguments provided.\n");
+	if(!parser -> function_errors_length) return LC_OK;
 
-		return LC_MORE_VALS;
-	}
+	/* The callback functions run after all of the arguments. */
+	state -> arg = state -> feeding? state -> fed: state -> args_length;
+	state -> flag = parser -> function_errors[0].flag;
 
-	return LC_OK;
+	parser -> err_function = parser -> function_errors[0].flag -> function;
+	parser -> function_errno = parser -> function_errors[0].function_errno;
+	return LC_FUNC_ERR;
 }
-static int get_others(LC_flag_t *flag, node_t *node, char *value) {
-	/* A single string with a given value can be set easily. */
-	if(!flag -> arr_length && value) {
-		/* We need to verify that they are the correct format and that
-		 * sscanf() didn't choke on the input. */
-		if(!flag -> fmt_string) return LC_NULL_FORMAT_STR;
 
-		/* We want the format string to end with %n, which makes sscanf
-		 * give us the number of bytes processed. */
-		size_t fmt_len = strlen(flag -> fmt_string);
+static size_t call_run(void *context, size_t begin, size_t end) {
+	LC_parser_t *parser = context;
+	__LC_state_t *state = parser -> state;
 
-		char fmt_debug[fmt_len + 4];
-		fmt_debug[0] = 0;
+	for(size_t i = begin; i < end; i++) {
+		/* Item zero is every callback function that has to run on
+		 * this thread, in order. */
+		if(i) {
+			size_t index = state -> independent[i - 1];
+			LC_flag_t *flag = &parser -> flags[index];
 
-		strncat(fmt_debug, flag -> fmt_string, fmt_len);
-		strncat(fmt_debug, "%zn", 3);
+			state -> calls[index].ret = flag -> function(flag);
+			continue;
+		}
 
-		size_t bytes = 0;
-		int ret = sscanf(value, fmt_debug, flag -> var_ptr, &bytes);
-		
-		if(ret != 1 || bytes != strlen(value)) {
-			fprintf(stderr, "%s: error: the string `%s' is "
-				"invalid for the flag", LC_prog_name, value
-			);
-			print_flag(flag);
-			fprintf(stderr, ".\n");
+		for(size_t j = 0; j < state -> queue_length; j++) {
+			size_t index = state -> queue[j];
+			LC_flag_t *flag = &parser -> flags[index];
 
-			return LC_BAD_VAL;
+			if(flag -> independent && state -> independent_length) {
+				continue;
+			}
+
+			state -> calls[index].ret = flag -> function(flag);
 		}
+	}
 
+	return end;
+}
+
+static int get_strings(LC_parser_t *parser, LC_flag_t *flag, char *value) {
+	__LC_state_t *state = parser -> state;
+
+	/* A single string with a given value can be set easily. */
+	if(!flag -> arr_length && value) {
+		*(char **) flag -> var_ptr = value;
+		state -> stored = true;
 		return LC_OK;
 	}
 
-	/* If it's just a single variable, get the value from the next node. */
+	/* If it's just a single variable, get the value from the next
+	 * argument. */
 	if(!flag -> arr_length && !value) {
-		/* Get the string. */
-		value = pop_node(node);
+		*(char **) flag -> var_ptr = pop_arg(parser);
+		state -> stored = true;
 
-		if(!value) {
-			fprintf(stderr, "%s: error: the flag ", LC_prog_name);
-			print_flag(flag);
+		if(!*(char **) flag -> var_ptr) {
+			fprintf(stderr, "%s: error: the flag ",
+				parser -> prog_name
+			);
+			print_flag(parser, flag);
 			fprintf(stderr, " needs an additional argument.\n");
 
 			return LC_NO_VAL;
 		}
 
-		/* Inject our tests into the format string and process the
-		 * value. */
-		if(!flag -> fmt_string) return LC_NULL_FORMAT_STR;
-		size_t fmt_len = strlen(flag -> fmt_string);
+		return LC_OK;
+	}
 
-		char fmt_debug[fmt_len + 4];
-		fmt_debug[0] = 0;
+	/* Since we have an array, collect the values in a single pass. They
+	 * run up to the next `--' or the end of the arguments. */
+	size_t length = 0, capacity = 0;
+	size_t size = sizeof(char *);
 
-		strncat(fmt_debug, flag -> fmt_string, fmt_len);
-		strncat(fmt_debug, "%zn", 3);
+	__LC_owned_t *owned = NULL;
+	void *array = NULL;
+	bool reused = false;
 
-		size_t bytes = 0;
-		int ret = sscanf(value, fmt_debug, flag -> var_ptr, &bytes);
-		
-		if(ret != 1 || bytes != strlen(value)) {
-			fprintf(stderr, "%s: error: the string `%s' is "
-				"invalid for the flag", LC_prog_name, value
-			);
-			print_flag(flag);
-			fprintf(stderr, ".\n");
+	/* Storage from the flag's reserve() function isn't ours to keep track
+	 * of. */
+	if(!flag -> reserve) {
+		owned = own_array(parser, flag, &capacity, size);
+		if(!owned) return LC_MALLOC_ERR;
+
+		array = *(void **) flag -> var_ptr;
+		reused = array && array == owned -> data;
+	}
+
+	state -> stored = true;
+
+	if(value && !push_strings(parser, flag, value, &array, &capacity,
+		&length))
+	{
+		return LC_MALLOC_ERR;
+	}
+
+	while(state -> next_arg < state -> args_length) {
+		char *string = state -> args[state -> next_arg++];
+
+		/* Get rid of the `--', which marks the end of the array. */
+		if(string[0] == '-' && string[1] == '-' && !string[2]) break;
 
-			return LC_BAD_VAL;
+		if(!push_strings(parser, flag, string, &array, &capacity,
+			&length))
+		{
+			return LC_MALLOC_ERR;
 		}
+	}
 
-		return LC_OK;
+	*(flag -> arr_length) = length;
+	if(owned && !finish_array(parser, flag, owned, reused, array, capacity,
+		length, size))
+	{
+		return LC_MALLOC_ERR;
 	}
 
-	/* Since we have an array, we're going to need to figure out how many
-	 * values there are in total. */
+	return check_length(parser, flag);
+}
 
-	/* We need a temporary variable to store the data as sscanf() tries to
-	 * read it. */
-	char testing_area[flag -> var_length];
+static int get_others(LC_parser_t *parser, LC_flag_t *flag, char *value) {
+	__LC_state_t *state = parser -> state;
 
-	/* Do our standard sscanf tests, reading the value provided to us. */
 	if(!flag -> fmt_string) return LC_NULL_FORMAT_STR;
-	size_t fmt_len = strlen(flag -> fmt_string);
 
+	/* Set up the converter. We only need to build the sscanf() format
+	 * string if we can't handle the conversion ourselves. */
+	converter_t converter;
+	converter.native = __LC_number_format(flag -> fmt_string,
+		&converter.number
+	);
+
+	size_t fmt_len = converter.native? 0: strlen(flag -> fmt_string);
 	char fmt_debug[fmt_len + 4];
-	fmt_debug[0] = 0;
 
-	strncat(fmt_debug, flag -> fmt_string, fmt_len);
-	strncat(fmt_debug, "%zn", 3);
+	if(!converter.native) {
+		memcpy(fmt_debug, flag -> fmt_string, fmt_len);
+		memcpy(&fmt_debug[fmt_len], "%zn", 4);
+	}
 
-	size_t bytes = 0;
-	size_t len = value? strlen(value): 0;
-	int ret = value? sscanf(value, fmt_debug, testing_area, &bytes): 1;
+	converter.fmt_debug = fmt_debug;
+
+	/* If it's just a single variable, get the value from the next
+	 * argument if there isn't one already. */
+	if(!flag -> arr_length) {
+		if(!value) value = pop_arg(parser);
+
+		if(!value) {
+			fprintf(stderr, "%s: error: the flag ",
+				parser -> prog_name
+			);
+			print_flag(parser, flag);
+			fprintf(stderr, " needs an additional argument.\n");
+
+			return LC_NO_VAL;
+		}
+
+		/* We need to verify that they are the correct format and that
+		 * the conversion didn't choke on the input. */
+		if(!convert(&converter, value, flag -> var_ptr)) {
+			return bad_value(parser, flag, value);
+		}
+
+		return LC_OK;
+	}
+
+	/* Since we have an array, convert each value straight into the array
+	 * as we go. The values run up to the next `--' or the first string
+	 * that isn't a valid value for the given datatype. */
+	size_t length = 0, capacity = 0;
+	size_t size = flag -> var_length;
+
+	__LC_owned_t *owned = NULL;
+	void *array = NULL;
+	bool reused = false;
+
+	if(!flag -> reserve) {
+		owned = own_array(parser, flag, &capacity, size);
+		if(!owned) return LC_MALLOC_ERR;
 
-	/* Error out if sscanf() can't read the value provided to us. */
-	if(ret != 1 || bytes != len) {
-		fprintf(stderr, "%s: error: the string `%s' is invalid for "
-			"the flag", LC_prog_name, value
+		array = *(void **) flag -> var_ptr;
+		reused = array && array == owned -> data;
+	}
+
+	/* Error out if we can't read the value provided to us. */
+	if(value) {
+		int ret = push_values(parser, flag, &converter, value, &array,
+			&capacity, &length
 		);
-		print_flag(flag);
-		fprintf(stderr, ".\n");
 
-		return LC_BAD_VAL;
+		if(ret == LC_BAD_VAL) return bad_value(parser, flag, value);
+		if(ret != LC_OK) return ret;
+	}
+
+	/* Whatever is left over afterwards, whether it's the `--' or a value
+	 * that doesn't convert, is dealt with by the loop below. */
+	if(parser -> convert_threads > 1 && !flag -> separator) {
+		int ret = convert_parallel(parser, flag, &converter, &array,
+			&capacity, &length
+		);
+
+		if(ret != LC_OK) return ret;
 	}
 
-	/* Since we have an array, check how many values we have in total. */
-	*(flag -> arr_length) = value? 1: 0;
+	while(state -> next_arg < state -> args_length) {
+		char *string = state -> args[state -> next_arg];
 
-	for(node_t *i = node -> next; i; i = i -> next) {
-		/* Check that the value isn't `--'. */
-		if(!strcmp(i -> string, "--")) {
-			/* Get rid of the `--', which marks the end of the
-			 * array. Break out. */
-			pop_node(i -> prev);
+		/* Get rid of the `--', which marks the end of the array. */
+		if(string[0] == '-' && string[1] == '-' && !string[2]) {
+			state -> next_arg++;
 			break;
 		}
 
-		/* Check if this is a valid value for the given datatype. */
-		ret = sscanf(i -> string, fmt_debug, testing_area, &bytes);
-		if(ret != 1 || bytes != strlen(i -> string)) break;
+		/* A value that doesn't convert isn't consumed. */
+		int ret = push_values(parser, flag, &converter, string, &array,
+			&capacity, &length
+		);
+
+		if(ret == LC_BAD_VAL) break;
+		if(ret != LC_OK) return ret;
+
+		state -> next_arg++;
+	}
 
-		++*(flag -> arr_length);
+	*(flag -> arr_length) = length;
+	if(owned && !finish_array(parser, flag, owned, reused, array, capacity,
+		length, size))
+	{
+		return LC_MALLOC_ERR;
 	}
 
-	/* If the array has already been allocated, de-allocate it. */
-	if(*(void **) flag -> var_ptr) free(*(void **) flag -> var_ptr);
+	return check_length(parser, flag);
+}
 
-	/* Allocate the memory for the array. We cannot portably call malloc()
-	 * with a size of zero. (This type is cursed.) */
-	*(void **) flag -> var_ptr = *(flag -> arr_length)?
-		malloc(*(flag -> arr_length) * flag -> var_length) :
-		malloc(sizeof(void *));
+static __LC_owned_t *own_array(LC_parser_t *parser, LC_flag_t *flag,
+	size_t *capacity, size_t size)
+{
+	__LC_state_t *state = parser -> state;
+	size_t *index = &state -> owned_flags[flag - parser -> flags];
 
-	if(!*(void **) flag -> var_ptr) return LC_MALLOC_ERR;
+	/* We only know how much room the array has if the variable still
+	 * points at the one we left there. */
+	if(*index) {
+		__LC_owned_t *owned = &state -> owned[*index - 1];
 
-	/* Scan over the value passed directly to us first. */
-	if(value) {
-		sscanf(value, flag -> fmt_string, *(void **) flag -> var_ptr);
+		bool ours = owned -> data && *owned -> array == owned -> data;
+		*capacity = ours? owned -> size / size: 0;
+		return owned;
 	}
 
-	/* Loop over and copy all the other values. */
-	for(size_t i = value? 1: 0; i < *(flag -> arr_length); i++) {
-		/* We need to use char ** here to stop the compiler complaining
-		 * about doing pointer arithmetic with void *. */
-		sscanf(pop_node(node), flag -> fmt_string,
-			*(char **) flag -> var_ptr + i * flag -> var_length
+	*capacity = 0;
+
+	if(state -> owned_length == state -> owned_capacity) {
+		size_t capacity = state -> owned_capacity?
+			state -> owned_capacity * 2: 16;
+
+		void *array = __LC_realloc(&state -> allocator, state -> owned,
+			capacity * sizeof(__LC_owned_t)
+		);
+
+		if(!array) return NULL;
+
+		state -> owned = array;
+		state -> owned_capacity = capacity;
+	}
+
+	__LC_owned_t *owned = &state -> owned[state -> owned_length++];
+
+	owned -> array = flag -> var_ptr;
+	owned -> length = flag -> arr_length;
+	owned -> data = NULL;
+	owned -> size = 0;
+
+	*index = state -> owned_length;
+	return owned;
+}
+
+static bool reserve_array(LC_parser_t *parser, LC_flag_t *flag, void **array,
+	size_t *capacity, size_t count, size_t size)
+{
+	if(count <= *capacity) return true;
+
+	/* Double the capacity each time, so that building up an array of n
+	 * values only ever copies O(n) of them. A long list of values in one
+	 * argument gets all the room it needs at once. */
+	size_t new_capacity = *capacity? *capacity * 2: 16;
+	if(new_capacity < count) new_capacity = count;
+
+	void *new_array;
+
+	if(flag -> reserve) new_array = flag -> reserve(flag, new_capacity);
+
+	else {
+		new_array = __LC_realloc(&parser -> state -> allocator, *array,
+			new_capacity * size
 		);
 	}
 
-	/* Let's go ahead and verify that the array length is acceptable. */
+	if(!new_array) return false;
+
+	/* Keep the variable pointing at the live array, so that nothing leaks
+	 * if we have to bail out part of the way through. */
+	*(void **) flag -> var_ptr = *array = new_array;
+	*capacity = new_capacity;
+	return true;
+}
+
+static bool finish_array(LC_parser_t *parser, LC_flag_t *flag,
+	__LC_owned_t *owned, bool reused, void *array, size_t capacity,
+	size_t length, size_t size)
+{
+	/* Shrinking an array we're going to parse into again would only mean
+	 * growing it again next time. */
+	if(reused) {
+		owned -> data = array;
+		owned -> size = capacity * size;
+		return true;
+	}
+
+	/* We cannot portably call realloc() with a size of zero. (This type is
+	 * cursed.) */
+	size_t bytes = length? length * size: sizeof(void *);
+
+	void *new_array = __LC_realloc(&parser -> state -> allocator, array,
+		bytes
+	);
+
+	if(!new_array) return false;
+
+	*(void **) flag -> var_ptr = owned -> data = new_array;
+	owned -> size = bytes;
+	return true;
+}
+
+static int check_length(LC_parser_t *parser, LC_flag_t *flag) {
+	/* Let's go ahead and verify that the array length is appropriate. */
 	if(*(flag -> arr_length) < flag -> min_arr_length) {
-		fprintf(stderr, "%s: error: the flag ", LC_prog_name);
-		print_flag(flag);
+		fprintf(stderr, "%s: error: the flag ", parser -> prog_name);
+		print_flag(parser, flag);
 		fprintf(stderr, " has too few arguments provided.\n");
 
 		return LC_LESS_VALS;
 	}
 
 	if(*(flag -> arr_length) > flag -> max_arr_length) {
-		fprintf(stderr, "%s: error: the flag ", LC_prog_name);
-		print_flag(flag);
+		fprintf(stderr, "%s: error: the flag ", parser -> prog_name);
+		print_flag(parser, flag);
 		fprintf(stderr, " has too many arguments provided.\n");
 
 		return LC_MORE_VALS;
@@ -596,31 +1513,227 @@ static int get_others(LC_flag_t *flag, node_t *node, char *value) {
 	return LC_OK;
 }
 
-static char *pop_node(node_t *node) {
+static bool convert(const converter_t *converter, const char *value,
+	void *dest)
+{
+	if(converter -> native) {
+		return __LC_number_parse(&converter -> number, value, dest);
+	}
+
+	/* The value is only valid if sscanf() used all of it. */
+	size_t bytes = 0;
+	int ret = sscanf(value, converter -> fmt_debug, dest, &bytes);
+	return ret == 1 && !value[bytes];
+}
+
+static bool convert_any(const void *converter, const char *value,
+	void *dest)
+{
+	return convert(converter, value, dest);
+}
+
+static int convert_parallel(LC_parser_t *parser, LC_flag_t *flag,
+	const converter_t *converter, void **array, size_t *capacity,
+	size_t *length)
+{
+	__LC_state_t *state = parser -> state;
+	char **values = &state -> args[state -> next_arg];
+
+	size_t count = 0, left = state -> args_length - state -> next_arg;
+
+	for(; count < left; count++) {
+		char *string = values[count];
+		if(string[0] == '-' && string[1] == '-' && !string[2]) break;
+	}
+
+	if(count < parser -> convert_threshold) return LC_OK;
+
+	size_t size = flag -> var_length;
+	if(!reserve_array(parser, flag, array, capacity, *length + count,
+		size))
+	{
+		return LC_MALLOC_ERR;
+	}
+
+	void *dest = (char *) *array + *length * size;
+	size_t converted = __LC_convert_all(convert_any, converter, values,
+		count, dest, size, parser -> convert_threads
+	);
+
+	*length += converted;
+	state -> next_arg += converted;
+	return LC_OK;
+}
+
+static bool convert_list(const converter_t *converter, char *value,
+	char separator, void *dest, size_t stride)
+{
+	if(!separator) return convert(converter, value, dest);
+
+	for(char *dest_ptr = dest;; dest_ptr += stride) {
+		/* Native conversions stop at the first character that isn't
+		 * part of the number, which has to be the separator or the
+		 * end. */
+		if(converter -> native) {
+			const char *end = __LC_number_scan(&converter -> number,
+				value, dest_ptr
+			);
+
+			if(!end || (*end && *end != separator)) return false;
+			if(!*end) return true;
+
+			value = (char *) end + 1;
+			continue;
+		}
+
+		/* sscanf() has to be given each element on its own, so we
+		 * cut the value off at the separator for the duration of the
+		 * call. */
+		char *end = strchr(value, separator);
+		if(end) *end = 0;
+
+		bool ret = convert(converter, value, dest_ptr);
+		if(end) *end = separator;
+
+		if(!ret) return false;
+		if(!end) return true;
+
+		value = end + 1;
+	}
+}
+
+static bool push_strings(LC_parser_t *parser, LC_flag_t *flag, char *value,
+	void **array, size_t *capacity, size_t *length)
+{
+	char separator = flag -> separator;
+	size_t count = separator? __LC_count(value, separator) + 1: 1;
+
+	if(!reserve_array(parser, flag, array, capacity, *length + count,
+		sizeof(char *)))
+	{
+		return false;
+	}
+
+	/* Split the value up in place, the same way LC_parse_string() splits up
+	 * its string. */
+	char **strings = *array;
+
+	for(size_t i = 0; i < count - 1; i++) {
+		char *end = strchr(value, separator);
+		*end = 0;
+
+		strings[(*length)++] = value;
+		value = end + 1;
+	}
+
+	strings[(*length)++] = value;
+	return true;
+}
+
+static int push_values(LC_parser_t *parser, LC_flag_t *flag,
+	const converter_t *converter, char *value, void **array,
+	size_t *capacity, size_t *length)
+{
+	char separator = flag -> separator;
+	size_t count = separator? __LC_count(value, separator) + 1: 1;
+	size_t size = flag -> var_length;
+
+	/* Counting the separators first means that the whole list gets room
+	 * in the array at once, and every element is converted straight into
+	 * its place. We need to use char * here to stop the compiler
+	 * complaining about doing pointer arithmetic with void *. */
+	if(!reserve_array(parser, flag, array, capacity, *length + count,
+		size))
+	{
+		return LC_MALLOC_ERR;
+	}
+
+	void *dest = (char *) *array + *length * size;
+	if(!convert_list(converter, value, separator, dest, size)) {
+		return LC_BAD_VAL;
+	}
+
+	*length += count;
+	return LC_OK;
+}
+
+static int bad_value(LC_parser_t *parser, LC_flag_t *flag, const char *value)
+{
+	__LC_state_t *state = parser -> state;
+
+	/* A value in an argument of its own is to blame rather than the flag's
+	 * argument. */
+	if(state -> next_arg && state -> args[state -> next_arg - 1] == value) {
+		state -> arg = state -> next_arg - 1;
+	}
+
+	fprintf(stderr, "%s: error: the string `%s' is invalid for the flag",
+		parser -> prog_name, value
+	);
+	print_flag(parser, flag);
+	fprintf(stderr, ".\n");
+
+	return LC_BAD_VAL;
+}
+
+static char *pop_arg(LC_parser_t *parser) {
+	__LC_state_t *state = parser -> state;
+
 	/* Break out early if someone calls us without any data to pop. */
-	if(!node) return NULL;
-	if(!node -> next) return NULL;
+	if(state -> next_arg >= state -> args_length) return NULL;
+	return state -> args[state -> next_arg++];
+}
+
+static int push_flagless(LC_parser_t *parser, char *string) {
+	__LC_state_t *state = parser -> state;
 
-	/* Bridge previous to next. */
-	node_t *next_to_next = node -> next -> next;
-	if(next_to_next) next_to_next -> prev = node;
+	/* Hand the argument straight over if there's a function for it. */
+	if(parser -> flagless_function) {
+		int ret = parser -> flagless_function(
+			parser -> flagless_context, string
+		);
+
+		if(ret != LC_FUNCTION_OK) {
+			parser -> err_function = NULL;
+			parser -> function_errno = ret;
+			return LC_FUNC_ERR;
+		}
 
-	/* Get the string out of the node and free it. */
-	char *string = node -> next -> string;
-	free(node -> next);
+		return LC_OK;
+	}
 
-	/* Bridge next to previous. */
-	node -> next = next_to_next;
+	state -> stored = true;
 
-	LC_flagless_args_length--;
-	return string;
+	/* There can never be more flagless arguments than there are arguments
+	 * left, so one allocation is always enough for LC_parse(). Arguments
+	 * that are fed in arrive bit by bit, so the array doubles for them. */
+	if(parser -> flagless_args_length == state -> flagless_args_capacity) {
+		size_t capacity = parser -> flagless_args_length
+			+ (state -> args_length - state -> next_arg) + 1;
+
+		if(capacity < state -> flagless_args_capacity * 2) {
+			capacity = state -> flagless_args_capacity * 2;
+		}
+
+		char **array = __LC_realloc(&state -> allocator,
+			parser -> flagless_args, capacity * sizeof(char *)
+		);
+
+		if(!array) return LC_MALLOC_ERR;
+
+		parser -> flagless_args = array;
+		state -> flagless_args_capacity = capacity;
+	}
+
+	parser -> flagless_args[parser -> flagless_args_length++] = string;
+	return LC_OK;
 }
 
-static void print_flag(LC_flag_t *flag) {
+static void print_flag(LC_parser_t *parser, LC_flag_t *flag) {
 	/* If we're processing a long flag, print long flags preferentially,
 	 * and vice versa. One or the other must be set already for us to have
 	 * been processing it as a flag. */
-	if(processing_lflag) {
+	if(parser -> state -> processing_lflag) {
 		if(flag -> long_flag) {
 			fprintf(stderr, "'--%s'", flag -> long_flag);
 		}
@@ -15,26 +15,204 @@
  * this program. If not, see <https://www.gnu.org/licenses/>. */
 
 /* Header Files */
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 /* Main Header File. */
 #include <libClame.hh>
 
+/* Make an entry for a flag, reusing one that a parser has finished with if
+ * there is one. */
+libClame::__entry_t *libClame::__table_t::make() {
+	std::lock_guard<std::mutex> guard{lock};
+	size_t id = length;
+
+	if(!free.empty()) {
+		id = free.back();
+		free.pop_back();
+	}
+
+	else {
+		if(length % chunk_size == 0) {
+			chunks.emplace_back(
+				new libClame::__entry_t[chunk_size]
+			);
+		}
+
+		length++;
+	}
+
+	auto& entry = (*this)[id];
+	entry.id = id;
+	entry.owner = NULL;
+	return &entry;
+}
+
+bool libClame::__table_t::claim(size_t id, const void *owner) {
+	std::lock_guard<std::mutex> guard{lock};
+	auto& entry = (*this)[id];
+
+	if(entry.owner && entry.owner != owner) return false;
+
+	entry.owner = owner;
+	return true;
+}
+
+void libClame::__table_t::release(size_t id, const void *owner) {
+	std::lock_guard<std::mutex> guard{lock};
+	auto& entry = (*this)[id];
+
+	/* A flag added to the same parser twice is only released once. */
+	if(entry.owner != owner) return;
+
+	/* Let go of the callback and the views straight away. */
+	entry = {};
+	free.push_back(id);
+}
+
+size_t libClame::__table_t::size() const {
+	std::lock_guard<std::mutex> guard{lock};
+	return length;
+}
+
+libClame::__table_t& libClame::__entries() {
+	static libClame::__table_t entries;
+	return entries;
+}
+
+libClame::__entry_t *libClame::__make_entry(
+	void *var, void (*commit)(libClame::__entry_t *entry),
+	libClame::callback_t function
+){
+	auto entry = libClame::__entries().make();
+
+	entry -> var = var;
+	entry -> c_value = NULL;
+	entry -> c_length = 0;
+	entry -> commit = commit;
+	entry -> function = function;
+	return entry;
+}
+
+void *libClame::__scratch(libClame::__entry_t *entry, size_t size) noexcept {
+	auto& scratch = entry -> scratch;
+	size_t length = (size + sizeof(std::max_align_t) - 1)
+		/ sizeof(std::max_align_t);
+
+	/* The space is kept for later parses, so it only grows. */
+	try { if(scratch.size() < length) scratch.resize(length); }
+	catch(...) { return NULL; }
+
+	return scratch.data();
+}
+
+/* The interned strings are copied into blocks of at least this size. */
+#define BLOCK_SIZE 4096
+
+/* The table of interned strings is open addressed, and kept at most half
+ * full so that the chains stay short. It's made on first use, so that flags
+ * can be made before main(), and locked while it's used, so that they can be
+ * made on several threads at once. */
+struct __strings_t {
+	std::vector<std::unique_ptr<char[]>> blocks;
+	char *block_free = NULL;
+	size_t block_left = 0;
+
+	std::vector<const char *> table;
+	size_t length = 0;
+
+	std::mutex lock;
+};
+
+static __strings_t& __strings() {
+	static __strings_t strings;
+	return strings;
+}
+
+/* FNV-1a, which is plenty for the few thousand strings a program has. */
+static size_t __hash(std::string_view string) {
+	uint64_t hash = UINT64_C(14695981039346656037);
+
+	for(unsigned char ch: string) {
+		hash ^= ch;
+		hash *= UINT64_C(1099511628211);
+	}
+
+	return (size_t) hash;
+}
+
+const char *libClame::__intern(std::string_view string) {
+	auto& strings = __strings();
+	std::lock_guard<std::mutex> guard{strings.lock};
+
+	/* Double the table before it gets more than half full. */
+	if(2 * (strings.length + 1) > strings.table.size()) {
+		size_t size = strings.table.empty()?
+			64: strings.table.size() * 2;
+		std::vector<const char *> table(size, NULL);
+
+		for(auto old: strings.table) {
+			if(!old) continue;
+
+			size_t i = __hash(old) & (size - 1);
+			while(table[i]) i = (i + 1) & (size - 1);
+			table[i] = old;
+		}
+
+		strings.table.swap(table);
+	}
+
+	size_t mask = strings.table.size() - 1;
+	size_t i = __hash(string) & mask;
+
+	for(; strings.table[i]; i = (i + 1) & mask) {
+		if(strings.table[i] == string) return strings.table[i];
+	}
+
+	/* Copy it into the current block, or a new one if it doesn't fit.
+	 * Strings longer than a block get one to themselves. */
+	size_t size = string.size() + 1;
+
+	if(size > strings.block_left) {
+		size_t block_size = std::max<size_t>(size, BLOCK_SIZE);
+		strings.blocks.emplace_back(new char[block_size]);
+
+		strings.block_free = strings.blocks.back().get();
+		strings.block_left = block_size;
+	}
+
+	char *copy = strings.block_free;
+	memcpy(copy, string.data(), string.size());
+	copy[string.size()] = 0;
+
+	strings.block_free += size;
+	strings.block_left -= size;
+
+	strings.table[i] = copy;
+	strings.length++;
+	return copy;
+}
+
+const char *libClame::__make_lflag(std::string& lflag) {
+	return lflag.empty()? NULL: libClame::__intern(lflag);
+}
+
 /* Flag to call a function */
 LC_flag_t libClame::make_call(
 	std::string lflag, char sflag, libClame::callback_t function
 ){
-	/* Copy the flag since lflag is invalid after function scope. */
-	libClame::__string_list.push_back(std::move(lflag));
-	const auto c_lflag = (*libClame::__string_list.rbegin()).c_str();
-
-	/* Add the function to our call table. */
-	libClame::__call_table[c_lflag] = function;
+	const auto c_lflag = libClame::__make_lflag(lflag);
+	auto entry = libClame::__make_entry(NULL, NULL, function);
 
 	/* Use our standard C macro to make the struct. */
-	return LC_flag_t LC_MAKE_CALL(
+	LC_flag_t flag = LC_MAKE_CALL(
 		c_lflag, sflag, libClame::__interceptor
 	);
+
+	flag.context = entry;
+	return flag;
 }
 
 /* Flag to set a boolean to a given value. */
@@ -45,25 +223,24 @@ static LC_flag_t __make_bool(
 	std::string& lflag, char sflag, bool& var, bool val,
 	libClame::callback_t function
 ){
-	/* Make a copy of the flag that won't get mutated. */
-	libClame::__string_list.push_back(std::move(lflag));
-	const auto c_lflag = (*libClame::__string_list.rbegin()).c_str();
-
-	/* Add the function to our call table. */
-	libClame::__call_table[c_lflag] = function;
+	const auto c_lflag = libClame::__make_lflag(lflag);
+	auto entry = libClame::__make_entry(NULL, NULL, function);
 
 	/* Make the structure. */
-	return LC_MAKE_BOOL_F(
+	LC_flag_t flag = LC_MAKE_BOOL_F(
 		c_lflag, sflag, var, val, libClame::__interceptor
 	);
+
+	flag.context = entry;
+	return flag;
 }
 
 /* Overloaded interface functions. */
 LC_flag_t libClame::make_bool(
 	std::string lflag, char sflag, bool& var, bool val
 ){
-	/* Pass in a dummy lambda that does nothing. */
-	return __make_bool(lflag, sflag, var, val, [](){});
+	/* Pass in an empty callback that does nothing. */
+	return __make_bool(lflag, sflag, var, val, {});
 }
 
 LC_flag_t libClame::make_bool(
@@ -75,43 +252,35 @@ LC_flag_t libClame::make_bool(
 
 /* Flags to get config strings */
 
+/* Move the value the C code found over to the C++ string. */
+static void __commit_string(libClame::__entry_t *entry) {
+	*(std::string *) entry -> var = (char *) entry -> c_value;
+}
+
+/* A view just looks at the value where the C code found it. */
+static void __commit_view(libClame::__entry_t *entry) {
+	*(std::string_view *) entry -> var = (char *) entry -> c_value;
+}
+
 /* Same trick as with the bools. */
-LC_flag_t __make_string(
-	std::string& lflag, char sflag, std::string* string_ptr,
+static LC_flag_t __make_string(
+	std::string& lflag, char sflag, void *var,
+	void (*commit)(libClame::__entry_t *entry),
 	libClame::callback_t function
 ){
-	/* Make a copy of the flag that won't get mutated. */
-	libClame::__string_list.push_back(std::move(lflag));
-	const auto c_lflag = (*libClame::__string_list.rbegin()).c_str();
-
-	/* Pointer to the string copied from argv[] that we'll share with C.
-	 * It has to be declared in the table since it lives beyond the scope
-	 * of these helper functions. */
-	auto& c_string = libClame::__c_string_table[c_lflag] = NULL;
+	const auto c_lflag = libClame::__make_lflag(lflag);
+	auto entry = libClame::__make_entry(var, commit, function);
 
-	/* Add the function to our shadow table. */
-	libClame::__shadow_table[c_lflag] = function;
-
-	/* Add the assignment wrapper function to our call table. */
-	libClame::__call_table[c_lflag] = [c_lflag, string_ptr]() {
-		/* Dereference the pointer to get a C++ reference. */
-		auto& string = *string_ptr;
-
-		/* Get a reference to the original items we instantialised. */
-		const auto& c_string = libClame::__c_string_table[c_lflag];
-		const auto& function = libClame::__shadow_table[c_lflag];
-
-		/* Move the value to a C++ string. */
-		string = c_string;
-
-		/* Run the callback code. */
-		function();
-	};
+	/* The C code writes a pointer into argv[] to the entry. */
+	auto& c_string = *(char **) &entry -> c_value;
 
 	/* Make the structure. */
-	return LC_MAKE_STRING_F(
+	LC_flag_t flag = LC_MAKE_STRING_F(
 		c_lflag, sflag, c_string, libClame::__interceptor
 	);
+
+	flag.context = entry;
+	return flag;
 }
 
 /* Overloaded interface functions. */
@@ -119,66 +288,71 @@ LC_flag_t libClame::make_string(
 	std::string lflag, char sflag, std::string& string,
 	libClame::callback_t function
 ){
-	return __make_string(lflag, sflag, &string, function);
+	return __make_string(
+		lflag, sflag, &string, __commit_string, function
+	);
 }
 
 /* Overloaded interface functions. */
 LC_flag_t libClame::make_string(
 	std::string lflag, char sflag, std::string& string
 ){
-	/* Pass in a dummy lambda that does nothing. */
-	return __make_string(lflag, sflag, &string, [](){});
+	/* Pass in an empty callback that does nothing. */
+	return __make_string(lflag, sflag, &string, __commit_string, {});
 }
 
-/* Code for handling string arrays. */
-template<template<typename> typename C>
-requires libClame::ok_container<C, std::string>
-static LC_flag_t __make_str_arr(
-	std::string& lflag, char sflag, C<std::string>* strings_ptr,
-	libClame::limits_t limits,
+LC_flag_t libClame::make_string(
+	std::string lflag, char sflag, std::string_view& view,
 	libClame::callback_t function
 ){
-	/* Make a copy of the flag that won't get mutated. */
-	libClame::__string_list.push_back(std::move(lflag));
-	const auto c_lflag = (*libClame::__string_list.rbegin()).c_str();
-
-	/* Pointer to C string arr copied from argv[] that we'll manage. */
-	auto& c_strarr_entry = libClame::__c_strarr_table[c_lflag] = {NULL, 0};
-	auto& c_strarr = std::get<char**>(c_strarr_entry);
-	auto& c_strarr_len = std::get<size_t>(c_strarr_entry);
-
-	/* Add the function to our shadow table. Empty lambda if nothing was
-	 * provided in the optional. */
-	libClame::__shadow_table[c_lflag] = function;
-
-	/* Add the wrapper function to our call table. */
-	libClame::__call_table[c_lflag] = [c_lflag, strings_ptr](){
-		/* Dereference the pointer to get a C++ reference. */
-		auto& strings = *strings_ptr;
+	return __make_string(lflag, sflag, &view, __commit_view, function);
+}
 
-		/* Get the reference to the array we were sharing with C */
-		auto& c_strarr_entry = libClame::__c_strarr_table[c_lflag];
-		auto& c_strarr = std::get<char**>(c_strarr_entry);
-		auto& c_strarr_len = std::get<size_t>(c_strarr_entry);
+LC_flag_t libClame::make_string(
+	std::string lflag, char sflag, std::string_view& view
+){
+	/* Pass in an empty callback that does nothing. */
+	return __make_string(lflag, sflag, &view, __commit_view, {});
+}
 
-		/* Get the reference to the function we were provided. */
-		const auto& function = libClame::__shadow_table[c_lflag];
+/* Code for handling string arrays. */
+template<template<typename> typename C>
+requires libClame::ok_container<C, std::string>
+static void __commit_str_arr(libClame::__entry_t *entry) {
+	auto& strings = *(C<std::string> *) entry -> var;
+	auto c_strarr = *(char ***) &entry -> c_value;
+
+	/* The C code leaves pointers to the values in the entry's scratch
+	 * space. Build each string straight from its value, in a container
+	 * that is sized once, instead of making empty strings and then
+	 * assigning to them. */
+	strings.assign(c_strarr, c_strarr + entry -> c_length);
+}
 
-		/* Clear the strings. */
-		strings.clear();
-		strings.resize(c_strarr_len);
+/* A span of views needs somewhere for the views to live, so they're kept in
+ * the entry for later parses to reuse. */
+static void __commit_view_arr(libClame::__entry_t *entry) {
+	auto& views = *(std::span<std::string_view> *) entry -> var;
+	auto c_strarr = *(char ***) &entry -> c_value;
 
-		/* Move the values to a C++ string list. */
-		size_t i1 = 0;
-		for(auto& i2: strings) i2 = c_strarr[i1++];
+	entry -> views.assign(c_strarr, c_strarr + entry -> c_length);
+	views = entry -> views;
+}
 
-		/* Free the array (but not the elements it points to.) */
-		std::free(c_strarr);
-		c_strarr = NULL;
+static LC_flag_t __make_str_arr(
+	std::string& lflag, char sflag, void *var,
+	void (*commit)(libClame::__entry_t *entry),
+	libClame::limits_t limits,
+	libClame::callback_t function
+){
+	const auto c_lflag = libClame::__make_lflag(lflag);
+	auto entry = libClame::__make_entry(var, commit, function);
 
-		/* Run the callback code. */
-		function();
-	};
+	/* The C code writes the pointers to the values into the entry's
+	 * scratch space, and where that is and how many there are to the
+	 * entry. */
+	auto& c_strarr = *(char ***) &entry -> c_value;
+	auto& c_strarr_len = entry -> c_length;
 
 	/* Get the limits for the array if they are defined. */
 	const auto set_limits = limits;
@@ -187,10 +361,14 @@ static LC_flag_t __make_str_arr(
 	const auto& max = std::get<1>(set_limits);
 
 	/* Make the structure. */
-	return LC_MAKE_STRING_ARR_BOUNDED_F(
+	LC_flag_t flag = LC_MAKE_STRING_ARR_BOUNDED_F(
 		c_lflag, sflag, c_strarr, c_strarr_len, min, max,
 		libClame::__interceptor
 	);
+
+	flag.context = entry;
+	flag.reserve = libClame::__reserve_scratch<char *>;
+	return flag;
 }
 
 template<template<typename> typename C>
@@ -198,7 +376,9 @@ requires libClame::ok_container<C, std::string>
 LC_flag_t libClame::make_str_arr(
 	std::string lflag, char sflag, C<std::string>& strings
 ){
-	return __make_str_arr(lflag, sflag, &strings, {0, SIZE_MAX}, [](){});
+	return __make_str_arr(
+		lflag, sflag, &strings, __commit_str_arr<C>, {0, SIZE_MAX}, {}
+	);
 }
 
 template<template<typename> typename C>
@@ -207,7 +387,10 @@ LC_flag_t libClame::make_str_arr(
 	std::string lflag, char sflag, C<std::string>& strings,
 	libClame::callback_t function
 ){
-	return __make_str_arr(lflag, sflag, &strings, {0, SIZE_MAX}, function);
+	return __make_str_arr(
+		lflag, sflag, &strings, __commit_str_arr<C>, {0, SIZE_MAX},
+		function
+	);
 }
 
 template<template<typename> typename C>
@@ -216,7 +399,9 @@ LC_flag_t libClame::make_str_arr(
 	std::string lflag, char sflag, C<std::string>& strings,
 	libClame::limits_t limits
 ){
-	return __make_str_arr(lflag, sflag, &strings, limits, [](){});
+	return __make_str_arr(
+		lflag, sflag, &strings, __commit_str_arr<C>, limits, {}
+	);
 }
 
 template<template<typename> typename C>
@@ -225,7 +410,9 @@ LC_flag_t libClame::make_str_arr(
 	std::string lflag, char sflag, C<std::string>& strings,
 	libClame::limits_t limits, libClame::callback_t function
 ){
-	return __make_str_arr(lflag, sflag, &strings, limits, function);
+	return __make_str_arr(
+		lflag, sflag, &strings, __commit_str_arr<C>, limits, function
+	);
 }
 
 /* Force templates to instantialise */
@@ -250,8 +437,82 @@ template LC_flag_t libClame::make_str_arr<c>( \
 instantialise(std::list)
 instantialise(std::vector)
 
+/* Overloaded interface functions for spans of views. */
+LC_flag_t libClame::make_str_arr(
+	std::string lflag, char sflag, std::span<std::string_view>& views
+){
+	return __make_str_arr(
+		lflag, sflag, &views, __commit_view_arr, {0, SIZE_MAX}, {}
+	);
+}
+
+LC_flag_t libClame::make_str_arr(
+	std::string lflag, char sflag, std::span<std::string_view>& views,
+	libClame::callback_t function
+){
+	return __make_str_arr(
+		lflag, sflag, &views, __commit_view_arr, {0, SIZE_MAX}, function
+	);
+}
+
+LC_flag_t libClame::make_str_arr(
+	std::string lflag, char sflag, std::span<std::string_view>& views,
+	libClame::limits_t limits
+){
+	return __make_str_arr(
+		lflag, sflag, &views, __commit_view_arr, limits, {}
+	);
+}
+
+LC_flag_t libClame::make_str_arr(
+	std::string lflag, char sflag, std::span<std::string_view>& views,
+	libClame::limits_t limits, libClame::callback_t function
+){
+	return __make_str_arr(
+		lflag, sflag, &views, __commit_view_arr, limits, function
+	);
+}
+
+/* What owns the entries of the flags that read() has used. */
+static const char __globals = 0;
+
 /* Command to begin command-line argument processing. */
 void libClame::read(int argc, char** argv, std::vector<LC_flag_t>& flags) {
+	auto ret = libClame::try_read(argc, argv, flags);
+
+	/* Throw an exception if the value wasn't LC_OK. */
+	if(!ret) throw libClame::exception(ret.error().code);
+
+	/* The copies can be skipped in favour of flagless_view(). */
+	if(!libClame::copy_args) return;
+
+	/* Copy out the flagless arguments, after the ones from any earlier
+	 * call. Inserting them all at once sizes the vector once. */
+	libClame::flagless_args.insert(libClame::flagless_args.end(),
+		LC_flagless_args, LC_flagless_args + LC_flagless_args_length
+	);
+
+	/* Copy out the program name. */
+	libClame::prog_name = LC_prog_name;
+}
+
+/* The same again without exceptions. */
+libClame::expected<libClame::result, libClame::error> libClame::try_read(
+	int argc, char **argv, std::vector<LC_flag_t>& flags
+) noexcept {
+	/* The flags belong to read() from now on, unless a parser has them
+	 * already. */
+	for(auto& flag: flags) {
+		if(flag.function != libClame::__interceptor) continue;
+		auto entry = (libClame::__entry_t *) flag.context;
+
+		if(!libClame::__entries().claim(entry -> id, &__globals)) {
+			return libClame::unexpected<libClame::error>(
+				libClame::error{LC_DUP_FLAG, 0, &flag}
+			);
+		}
+	}
+
 	/* Set up the C flags structure. */
 	LC_flags = flags.data();
 	LC_flags_length = flags.size();
@@ -259,18 +520,13 @@ void libClame::read(int argc, char** argv, std::vector<LC_flag_t>& flags) {
 	/* Call the C parsing function. */
 	int ret = LC_read(argc, argv);
 
-	/* Throw an exception if the value wasn't LC_OK. */
-	if(ret != LC_OK) throw libClame::exception(ret);
-
-	/* Copy out the flagless arguments. */
-	libClame::flagless_args.reserve(LC_flagless_args_length);
-
-	for(size_t i = 0; i < LC_flagless_args_length; i++) {
-		libClame::flagless_args.push_back(LC_flagless_args[i]);
+	if(ret != LC_OK) {
+		return libClame::unexpected<libClame::error>(
+			libClame::error{ret, LC_err_index, LC_err_flag}
+		);
 	}
 
-	/* Copy out the program name. */
-	libClame::prog_name = LC_prog_name;
+	return libClame::result{libClame::flagless_view(), LC_prog_name};
 }
 
 /* Non-flag variables encountered during processing. */
@@ -279,6 +535,13 @@ std::vector<std::string> libClame::flagless_args;
 /* Program name set via argv[0]. */
 std::string libClame::prog_name;
 
+/* Views of the arguments instead of copies. */
+bool libClame::copy_args = true;
+
+std::span<char *> libClame::flagless_view() {
+	return {LC_flagless_args, LC_flagless_args_length};
+}
+
 /* Exception logic code for if read() throws. */
 libClame::exception::exception(int error): error{error} {}
 libClame::exception::~exception() noexcept {}
@@ -287,25 +550,84 @@ const char *libClame::exception::what() const noexcept {
 	return LC_strerror(this -> error);
 }
 
-/* Tables for C/C++ interop. */
-std::list<std::string> libClame::__string_list;
-std::unordered_map<std::string, libClame::callback_t> libClame::__call_table;
-std::unordered_map<std::string, libClame::callback_t> libClame::__shadow_table;
+/* Parsers with their own flags. */
+libClame::parser::parser() {
+	if(LC_parser_init(&c, NULL, 0) != LC_OK) {
+		throw libClame::exception(LC_MALLOC_ERR);
+	}
+}
+
+libClame::parser::~parser() {
+	/* The arrays the C code made for the flags are in our entries, which
+	 * are still around until we're done here. */
+	LC_parser_release(&c);
+	LC_parser_free(&c);
+
+	for(auto id: entries) libClame::__entries().release(id, this);
+}
+
+void libClame::parser::add(LC_flag_t flag) {
+	/* Flags made here call the interceptor, and their context is their
+	 * entry. Flags made with the C macros don't have one. */
+	if(flag.function == libClame::__interceptor) {
+		auto id = ((libClame::__entry_t *) flag.context) -> id;
+		entries.push_back(id);
+
+		if(!libClame::__entries().claim(id, this)) {
+			entries.pop_back();
+			throw libClame::exception(LC_DUP_FLAG);
+		}
+	}
+
+	flags.push_back(flag);
+}
+
+void libClame::parser::read(int argc, char **argv) {
+	auto ret = try_read(argc, argv);
+	if(!ret) throw libClame::exception(ret.error().code);
+}
+
+libClame::expected<libClame::result, libClame::error>
+libClame::parser::try_read(int argc, char **argv) noexcept {
+	/* The flags may have moved since the last parse. */
+	c.flags = flags.data();
+	c.flags_length = flags.size();
+
+	int ret = LC_parse(&c, argc, argv);
+
+	if(ret != LC_OK) {
+		return libClame::unexpected<libClame::error>(
+			libClame::error{ret, c.err_index, c.err_flag}
+		);
+	}
 
-std::unordered_map<std::string, char*> libClame::__c_string_table;
+	return libClame::result{flagless_args(), c.prog_name};
+}
+
+void libClame::parser::reset() {
+	/* LC_parse() keeps track of which flags have been set itself, and
+	 * starts afresh each time, so only the results need forgetting. The
+	 * arrays behind them are kept for the next parse. */
+	c.flagless_args_length = 0;
+	c.function_errors_length = 0;
+	c.prog_name = NULL;
+}
+
+std::span<char *> libClame::parser::flagless_args() const {
+	return {c.flagless_args, c.flagless_args_length};
+}
 
-std::unordered_map<std::string, std::tuple<char**, size_t>>
-	libClame::__c_strarr_table;
+const char *libClame::parser::prog_name() const { return c.prog_name; }
+LC_parser_t& libClame::parser::c_parser() { return c; }
 
 /* Function call __interceptor. */
 int libClame::__interceptor(LC_flag_t* c_flag) {
-	/* Synthesize our flastringgs into a C++ type. */
-	const auto lflag = std::string{c_flag -> long_flag};
+	/* The flag's context takes us straight to its entry. */
+	auto entry = (libClame::__entry_t *) c_flag -> context;
 
-	/* Look the correct C++ function up in the calltable. */
 	try {
-		const auto function = libClame::__call_table.at(lflag);
-		function();
+		if(entry -> commit) entry -> commit(entry);
+		entry -> function();
 	}
 
 	catch(...) {
@@ -0,0 +1,192 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "LC_internal.h"
+
+bool __LC_number_format(const char *fmt, __LC_number_t *number) {
+	/* We only handle format strings that are a single conversion. */
+	if(*fmt++ != '%') return false;
+
+	/* Work out the size of the variable from the length modifier. */
+	size_t size = sizeof(int);
+
+	switch(fmt[0]) {
+		case 'h': size = fmt[1] == 'h'? sizeof(char): sizeof(short); break;
+		case 'l': size = fmt[1] == 'l'? sizeof(long long): sizeof(long); break;
+		case 'j': size = sizeof(intmax_t); break;
+		case 'z': size = sizeof(size_t); break;
+		case 't': size = sizeof(ptrdiff_t); break;
+	}
+
+	/* Floating point conversions only take an `l' or an `L'. */
+	char conversion = fmt[fmt[0] == 'l' || fmt[0] == 'L'];
+
+	if(conversion && strchr("fFeEgGaA", conversion)) {
+		if(fmt[0] == 'L') {
+			number -> type = __LC_LONG_DOUBLE;
+			number -> size = sizeof(long double);
+		}
+
+		else if(fmt[0] == 'l') {
+			number -> type = __LC_DOUBLE;
+			number -> size = sizeof(double);
+		}
+
+		else {
+			number -> type = __LC_FLOAT;
+			number -> size = sizeof(float);
+		}
+
+		fmt += fmt[0] == 'l' || fmt[0] == 'L';
+		return !fmt[1];
+	}
+
+	/* Skip over the modifier, which is at most two characters long. */
+	if(fmt[0] == 'h' || fmt[0] == 'l') fmt += fmt[1] == fmt[0]? 2: 1;
+	else if(fmt[0] == 'j' || fmt[0] == 'z' || fmt[0] == 't') fmt++;
+
+	/* And the base and signedness from the conversion. */
+	number -> type = __LC_INTEGER;
+
+	switch(fmt[0]) {
+		case 'd': number -> is_signed = true; number -> base = 10; break;
+		case 'i': number -> is_signed = true; number -> base = 0; break;
+		case 'u': number -> is_signed = false; number -> base = 10; break;
+		case 'o': number -> is_signed = false; number -> base = 8; break;
+		case 'x': number -> is_signed = false; number -> base = 16; break;
+		case 'X': number -> is_signed = false; number -> base = 16; break;
+		default: return false;
+	}
+
+	/* Anything after the conversion (such as literal text that sscanf()
+	 * would have to match) is left to sscanf(). */
+	if(fmt[1]) return false;
+
+	if(size != 1 && size != 2 && size != 4 && size != 8) return false;
+	number -> size = size;
+	return true;
+}
+
+/* Get the value of a digit in any base up to 16, or 16 if it isn't one. */
+static unsigned digit_value(char ch) {
+	if(ch >= '0' && ch <= '9') return ch - '0';
+	if(ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+	if(ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+	return 16;
+}
+
+/* Floating point values are left to the C library. Like sscanf(), values out
+ * of range become infinities or zeroes rather than errors. */
+static const char *scan_real(const __LC_number_t *number, const char *string,
+	void *dest)
+{
+	char *end;
+
+	if(number -> type == __LC_FLOAT) {
+		float value = strtof(string, &end);
+		memcpy(dest, &value, sizeof(value));
+	}
+
+	else if(number -> type == __LC_DOUBLE) {
+		double value = strtod(string, &end);
+		memcpy(dest, &value, sizeof(value));
+	}
+
+	else {
+		long double value = strtold(string, &end);
+		memcpy(dest, &value, sizeof(value));
+	}
+
+	return end == string? NULL: end;
+}
+
+const char *__LC_number_scan(const __LC_number_t *number, const char *string,
+	void *dest)
+{
+	if(number -> type != __LC_INTEGER) {
+		return scan_real(number, string, dest);
+	}
+
+	/* Like sscanf(), we allow leading whitespace, but only the whitespace
+	 * of the C locale. */
+	while(*string == ' ' || (*string >= '\t' && *string <= '\r')) string++;
+
+	/* Get the sign. Unsigned values can't be negative; sscanf() would
+	 * have wrapped them around. */
+	bool negative = false;
+
+	if(*string == '+') string++;
+
+	else if(*string == '-') {
+		if(!number -> is_signed) return NULL;
+		negative = true;
+		string++;
+	}
+
+	/* Work out the base, skipping over any prefix it allows. */
+	unsigned base = number -> base;
+
+	if(base == 0) {
+		if(string[0] != '0') base = 10;
+		else if(string[1] == 'x' || string[1] == 'X') base = 16;
+		else base = 8;
+	}
+
+	if(base == 16 && string[0] == '0' && (string[1] == 'x'
+		|| string[1] == 'X') && digit_value(string[2]) < 16)
+	{
+		string += 2;
+	}
+
+	/* We need at least one digit, and the number runs up to the first
+	 * character that isn't one. */
+	if(digit_value(*string) >= base) return NULL;
+
+	uint64_t value = 0;
+
+	for(unsigned digit; (digit = digit_value(*string)) < base; string++) {
+		if(value > (UINT64_MAX - digit) / base) return NULL;
+		value = value * base + digit;
+	}
+
+	/* Check that the value fits the variable. Signed variables can hold
+	 * one more negative value than positive ones. */
+	unsigned bits = number -> size * 8;
+
+	uint64_t limit = number -> is_signed?
+		(UINT64_C(1) << (bits - 1)) - (negative? 0: 1):
+		(bits == 64? UINT64_MAX: (UINT64_C(1) << bits) - 1);
+
+	if(value > limit) return NULL;
+
+	/* Store it away at the right width. Negating in unsigned arithmetic
+	 * and then converting gives us the two's complement value without
+	 * overflowing anything. */
+	if(negative) value = -value;
+
+	switch(number -> size) {
+		case 1: { uint8_t v = value; memcpy(dest, &v, 1); break; }
+		case 2: { uint16_t v = value; memcpy(dest, &v, 2); break; }
+		case 4: { uint32_t v = value; memcpy(dest, &v, 4); break; }
+		case 8: { uint64_t v = value; memcpy(dest, &v, 8); break; }
+	}
+
+	return string;
+}
@@ -0,0 +1,138 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+/* We need sysconf() to count the processors, which isn't part of C99. */
+#define _DEFAULT_SOURCE 1
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "LC_internal.h"
+
+/* More threads than this would spend longer starting up than working. */
+#define MAX_THREADS 64
+
+/* A run of items for one thread to work through, and where it stopped. */
+typedef struct {
+	__LC_job_t job;
+	void *context;
+
+	size_t begin, end;
+	size_t stopped;
+
+} run_t;
+
+static void *run(void *arg) {
+	run_t *run = arg;
+
+	run -> stopped = run -> job(run -> context, run -> begin, run -> end);
+	return NULL;
+}
+
+size_t __LC_threads(size_t threads) {
+	/* There's no point running more threads than there are processors to
+	 * run them on. */
+	long processors = sysconf(_SC_NPROCESSORS_ONLN);
+	if(processors > 0 && threads > (size_t) processors) {
+		threads = processors;
+	}
+
+	return threads? threads: 1;
+}
+
+size_t __LC_parallel(__LC_job_t job, void *context, size_t count,
+	size_t threads)
+{
+	if(!count) return count;
+
+	if(threads > MAX_THREADS) threads = MAX_THREADS;
+	if(threads > count) threads = count;
+	if(threads < 1) threads = 1;
+
+	run_t runs[threads];
+	pthread_t ids[threads];
+	bool started[threads];
+
+	/* Split the items up evenly, giving the first few runs one extra item
+	 * each if they don't divide up exactly. */
+	size_t chunk = count / threads, extra = count % threads;
+
+	for(size_t i = 0, begin = 0; i < threads; i++) {
+		size_t end = begin + chunk + (i < extra);
+
+		runs[i] = (run_t) {job, context, begin, end, end};
+		begin = end;
+	}
+
+	/* This thread takes the first run itself. If a thread can't be
+	 * started, we just do its run here afterwards instead. */
+	started[0] = false;
+
+	for(size_t i = 1; i < threads; i++) {
+		started[i] = !pthread_create(&ids[i], NULL, run, &runs[i]);
+	}
+
+	run(&runs[0]);
+
+	for(size_t i = 1; i < threads; i++) {
+		if(started[i]) pthread_join(ids[i], NULL);
+		else run(&runs[i]);
+	}
+
+	/* The runs are in order, so the first one that stopped early has the
+	 * first item that stopped, whichever thread finished first. */
+	for(size_t i = 0; i < threads; i++) {
+		if(runs[i].stopped < runs[i].end) return runs[i].stopped;
+	}
+
+	return count;
+}
+
+/* The values to convert, for convert_run(). */
+typedef struct {
+	__LC_convert_t convert;
+	const void *converter;
+
+	char **values;
+	char *dest;
+	size_t size;
+
+} conversion_t;
+
+static size_t convert_run(void *context, size_t begin, size_t end) {
+	conversion_t *conversion = context;
+	char *dest = conversion -> dest + begin * conversion -> size;
+
+	for(size_t i = begin; i < end; i++, dest += conversion -> size) {
+		if(!conversion -> convert(conversion -> converter,
+			conversion -> values[i], dest))
+		{
+			return i;
+		}
+	}
+
+	return end;
+}
+
+size_t __LC_convert_all(__LC_convert_t convert, const void *converter,
+	char **values, size_t count, void *dest, size_t size, size_t threads)
+{
+	conversion_t conversion = {convert, converter, values, dest, size};
+
+	return __LC_parallel(convert_run, &conversion, count,
+		__LC_threads(threads)
+	);
+}
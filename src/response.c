@@ -0,0 +1,226 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+/* We need mmap() and friends, which aren't part of C99. */
+#define _DEFAULT_SOURCE 1
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "LC_internal.h"
+
+/* Some BSDs only know the older name. */
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+/* Append an argument to the expanded list, growing it geometrically. */
+static int push_arg(__LC_expansion_t *expansion, char *arg) {
+	if(expansion -> length == expansion -> capacity) {
+		size_t capacity = expansion -> capacity?
+			expansion -> capacity * 2: 64;
+
+		char **args = __LC_realloc(expansion -> allocator,
+			expansion -> args, capacity * sizeof(char *)
+		);
+
+		if(!args) return LC_MALLOC_ERR;
+
+		expansion -> args = args;
+		expansion -> capacity = capacity;
+	}
+
+	expansion -> args[expansion -> length++] = arg;
+	return LC_OK;
+}
+
+/* Remember a mapping so that it can be released later. */
+static int push_map(__LC_expansion_t *expansion, void *addr, size_t length) {
+	if(expansion -> maps_length == expansion -> maps_capacity) {
+		size_t capacity = expansion -> maps_capacity?
+			expansion -> maps_capacity * 2: 4;
+
+		__LC_mapping_t *maps = __LC_realloc(expansion -> allocator,
+			expansion -> maps, capacity * sizeof(__LC_mapping_t)
+		);
+
+		if(!maps) return LC_MALLOC_ERR;
+
+		expansion -> maps = maps;
+		expansion -> maps_capacity = capacity;
+	}
+
+	expansion -> maps[expansion -> maps_length].addr = addr;
+	expansion -> maps[expansion -> maps_length].length = length;
+	expansion -> maps_length++;
+	return LC_OK;
+}
+
+char *__LC_map_file(__LC_expansion_t *expansion, int fd, size_t size) {
+	size_t page = (size_t) sysconf(_SC_PAGESIZE);
+	size_t length = (size + 1 + page - 1) / page * page;
+
+	/* Reserve the whole region with anonymous zero pages first, then map
+	 * the file over the start of it. */
+	char *addr = mmap(NULL, length, PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+	);
+
+	if(addr == MAP_FAILED) return NULL;
+
+	if(mmap(addr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED,
+		fd, 0) == MAP_FAILED)
+	{
+		munmap(addr, length);
+		return NULL;
+	}
+
+	if(push_map(expansion, addr, length) != LC_OK) {
+		munmap(addr, length);
+		return NULL;
+	}
+
+	return addr;
+}
+
+/* Expand a single argument, recursing into response files. */
+static int expand_arg(__LC_expansion_t *expansion, char *arg, size_t depth,
+	size_t max_depth, const char *prog_name)
+{
+	/* Anything that isn't an `@file' goes through untouched. */
+	if(arg[0] != '@' || !arg[1]) return push_arg(expansion, arg);
+
+	/* Like GCC, we leave the argument alone if there's no such file. */
+	int fd = open(&arg[1], O_RDONLY);
+	if(fd == -1) return push_arg(expansion, arg);
+
+	if(depth >= max_depth) {
+		fprintf(stderr, "%s: error: the response file `%s' is nested "
+			"too deeply.\n", prog_name, &arg[1]
+		);
+
+		close(fd);
+		return LC_RESPONSE_ERR;
+	}
+
+	struct stat info;
+	if(fstat(fd, &info) == -1) {
+		fprintf(stderr, "%s: error: can't read the response file "
+			"`%s'.\n", prog_name, &arg[1]
+		);
+
+		close(fd);
+		return LC_RESPONSE_ERR;
+	}
+
+	/* An empty file simply expands to nothing. */
+	size_t size = (size_t) info.st_size;
+	if(!size) {
+		close(fd);
+		return LC_OK;
+	}
+
+	char *contents = __LC_map_file(expansion, fd, size);
+	close(fd); // The mapping stays valid without the descriptor.
+
+	if(!contents) {
+		fprintf(stderr, "%s: error: can't read the response file "
+			"`%s'.\n", prog_name, &arg[1]
+		);
+
+		return LC_RESPONSE_ERR;
+	}
+
+	/* Split the file up and expand each of the arguments in it. */
+	char *cursor = contents, *end = contents + size;
+
+	for(char *token; (token = __LC_next_token(&cursor, end));) {
+		int ret = expand_arg(expansion, token, depth + 1, max_depth,
+			prog_name
+		);
+
+		if(ret != LC_OK) return ret;
+	}
+
+	return LC_OK;
+}
+
+int __LC_expand(__LC_expansion_t *expansion, int argc, char **argv,
+	size_t max_depth, const char *prog_name)
+{
+	/* Release the files from any previous expansion. */
+	__LC_expansion_clear(expansion);
+
+	/* Don't bother copying argv[] if there's nothing to expand. */
+	int first = 1;
+	while(first < argc && (argv[first][0] != '@' || !argv[first][1])) {
+		first++;
+	}
+
+	if(first == argc) {
+		expansion -> argv = argv;
+		expansion -> argc = argc;
+		return LC_OK;
+	}
+
+	/* Copy the arguments up to the first `@file' over directly. */
+	for(int i = 0; i < first; i++) {
+		int ret = push_arg(expansion, argv[i]);
+		if(ret != LC_OK) return ret;
+	}
+
+	for(int i = first; i < argc; i++) {
+		int ret = expand_arg(expansion, argv[i], 0, max_depth,
+			prog_name
+		);
+
+		if(ret != LC_OK) return ret;
+	}
+
+	expansion -> argv = expansion -> args;
+	expansion -> argc = expansion -> length;
+	return LC_OK;
+}
+
+void __LC_expansion_clear(__LC_expansion_t *expansion) {
+	for(size_t i = 0; i < expansion -> maps_length; i++) {
+		munmap(expansion -> maps[i].addr, expansion -> maps[i].length);
+	}
+
+	/* Hold on to the arrays themselves so that they can be reused. */
+	expansion -> maps_length = 0;
+	expansion -> length = 0;
+	expansion -> argv = NULL;
+	expansion -> argc = 0;
+}
+
+void __LC_expansion_free(__LC_expansion_t *expansion) {
+	__LC_expansion_clear(expansion);
+
+	__LC_free(expansion -> allocator, expansion -> args);
+	__LC_free(expansion -> allocator, expansion -> maps);
+
+	expansion -> args = NULL;
+	expansion -> length = expansion -> capacity = 0;
+	expansion -> maps = NULL;
+	expansion -> maps_capacity = 0;
+}
@@ -0,0 +1,219 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+/* We need fstat(), lseek() and read(), which aren't part of C99. */
+#define _DEFAULT_SOURCE 1
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "LC_internal.h"
+
+/* The smallest block we read into. Blocks only get bigger than this when a
+ * single argument doesn't fit in one. */
+#define BLOCK_SIZE 65536
+
+void __LC_blocks_free(LC_parser_t *parser) {
+	__LC_state_t *state = parser -> state;
+
+	for(size_t i = 0; i < state -> blocks_length; i++) {
+		__LC_free(&state -> allocator, state -> blocks[i]);
+	}
+
+	state -> blocks_length = 0;
+}
+
+/* Allocate a block with a spare byte after its end for a null byte, and keep
+ * track of it until the next parse. */
+static char *push_block(LC_parser_t *parser, size_t size) {
+	__LC_state_t *state = parser -> state;
+
+	if(state -> blocks_length == state -> blocks_capacity) {
+		size_t capacity = state -> blocks_capacity?
+			state -> blocks_capacity * 2: 4;
+
+		char **blocks = __LC_realloc(&state -> allocator,
+			state -> blocks, capacity * sizeof(char *)
+		);
+
+		if(!blocks) return NULL;
+
+		state -> blocks = blocks;
+		state -> blocks_capacity = capacity;
+	}
+
+	char *block = __LC_realloc(&state -> allocator, NULL, size + 1);
+	if(!block) return NULL;
+
+	state -> blocks[state -> blocks_length++] = block;
+	return block;
+}
+
+/* Feed in every argument between *cursor and end that has its delimiter, and
+ * move *cursor to the start of the one left over. The delimiters are replaced
+ * with null bytes, which does nothing at all for `-print0' style input. */
+static int feed_args(LC_parser_t *parser, char **cursor, char *end,
+	char delimiter)
+{
+	char *start = *cursor, *found;
+
+	while((found = memchr(start, delimiter, end - start))) {
+		*found = 0;
+
+		int ret = LC_feed(parser, start);
+		start = found + 1;
+
+		if(ret != LC_OK) break;
+	}
+
+	*cursor = start;
+	return parser -> state -> feed_ret;
+}
+
+/* Regular files are mapped in, and split up right where they are. */
+static int feed_file(LC_parser_t *parser, char *contents, size_t size,
+	char delimiter)
+{
+	char *cursor = contents, *end = contents + size;
+
+	int ret = feed_args(parser, &cursor, end, delimiter);
+	if(ret != LC_OK) return ret;
+
+	/* The last argument doesn't need a delimiter after it, since the
+	 * mapping has a zero byte past the end of the file. */
+	if(cursor < end) return LC_feed(parser, cursor);
+	return LC_OK;
+}
+
+/* Anything else is read a block at a time. */
+static int feed_stream(LC_parser_t *parser, int fd, char delimiter) {
+	__LC_state_t *state = parser -> state;
+
+	char *block = NULL;
+	size_t size = 0, start = 0, used = 0;
+
+	while(true) {
+		/* Make room for more, keeping the argument that's been cut off
+		 * at the end of the block. */
+		if(used == size) {
+			size_t partial = used - start;
+
+			/* If none of the arguments in the block are in use, the
+			 * block can be used again. */
+			if(block && !state -> stored && !state -> pending_length
+				&& start)
+			{
+				memmove(block, &block[start], partial);
+			}
+
+			else {
+				size = partial * 2 > BLOCK_SIZE?
+					partial * 2: BLOCK_SIZE;
+
+				char *next = push_block(parser, size);
+				if(!next) return LC_MALLOC_ERR;
+
+				if(partial) {
+					memcpy(next, &block[start], partial);
+				}
+
+				block = next;
+				state -> stored = false;
+			}
+
+			start = 0;
+			used = partial;
+		}
+
+		ssize_t bytes = read(fd, &block[used], size - used);
+
+		if(bytes == -1 && errno == EINTR) continue;
+		if(bytes == -1) return LC_READ_ERR;
+		if(bytes == 0) break;
+
+		char *cursor = &block[start], *end = &block[used + bytes];
+		used += bytes;
+
+		int ret = feed_args(parser, &cursor, end, delimiter);
+		start = cursor - block;
+
+		if(ret != LC_OK) return ret;
+	}
+
+	/* Use the spare byte to end the last argument. */
+	if(start < used) {
+		block[used] = 0;
+		return LC_feed(parser, &block[start]);
+	}
+
+	return LC_OK;
+}
+
+int LC_parse_fd(LC_parser_t *parser, char *prog_name, int fd,
+	char delimiter)
+{
+	__LC_state_t *state = parser -> state;
+
+	/* Nothing from the last parse is in use any more. Feeding in the
+	 * program name abandons anything that was already being fed in. */
+	__LC_blocks_free(parser);
+	state -> feeding = false;
+
+	int ret = LC_feed(parser, prog_name);
+
+	/* Map regular files in, as long as nothing has been read from them
+	 * yet, and move past the arguments as if they had been read. */
+	struct stat info;
+
+	if(ret == LC_OK && fstat(fd, &info) != -1 && S_ISREG(info.st_mode)
+		&& info.st_size > 0 && lseek(fd, 0, SEEK_CUR) == 0)
+	{
+		size_t size = (size_t) info.st_size;
+		char *contents = __LC_map_file(&state -> expansion, fd, size);
+
+		if(contents) {
+			lseek(fd, info.st_size, SEEK_SET);
+
+			/* Errors stick, and come back out of LC_finish(). */
+			(void) feed_file(parser, contents, size, delimiter);
+			return LC_finish(parser);
+		}
+	}
+
+	if(ret == LC_OK) ret = feed_stream(parser, fd, delimiter);
+
+	/* Errors while parsing are reported when we finish, and anything
+	 * else means that we have to give up on the arguments, just past the
+	 * ones that were read in. */
+	if(ret == LC_OK || ret == state -> feed_ret) return LC_finish(parser);
+
+	state -> arg = state -> fed + state -> pending_length;
+	state -> flag = NULL;
+
+	if(ret == LC_READ_ERR) {
+		fprintf(stderr, "%s: error: can't read the arguments.\n",
+			parser -> prog_name
+		);
+	}
+
+	state -> feeding = false;
+	state -> pending_length = 0;
+	return __LC_stopped(parser, ret);
+}
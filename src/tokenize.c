@@ -0,0 +1,89 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include "LC_internal.h"
+
+/* We only split on the whitespace characters from the C locale, so that the
+ * result never depends on the user's environment. */
+static bool is_space(char ch) {
+	return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\v'
+		|| ch == '\f' || ch == '\r';
+}
+
+char *__LC_next_token(char **cursor, char *end) {
+	char *read = *cursor;
+
+	/* Skip over the whitespace before the token. */
+	while(read < end && is_space(*read)) read++;
+
+	if(read >= end) {
+		*cursor = end;
+		return NULL;
+	}
+
+	/* Unquoting only ever makes the token shorter, so we can write it back
+	 * over itself as we go. */
+	char *token = read, *write = read;
+	char quote = 0; // The quote character we are inside of, if any.
+
+	while(read < end) {
+		char ch = *read++;
+
+		/* Everything up to the closing single quote is literal. */
+		if(quote == '\'') {
+			if(ch == '\'') quote = 0;
+			else *write++ = ch;
+		}
+
+		/* Inside double quotes, a backslash only escapes characters
+		 * that would otherwise mean something, which includes the `$'
+		 * and the backquote even though we don't expand anything. */
+		else if(quote == '"') {
+			if(ch == '"') quote = 0;
+
+			else if(ch == '\\' && read < end && (*read == '"'
+				|| *read == '\\' || *read == '\n' || *read == '$'
+				|| *read == '`'))
+			{
+				if(*read != '\n') *write++ = *read;
+				read++;
+			}
+
+			else *write++ = ch;
+		}
+
+		/* Unquoted whitespace ends the token. */
+		else if(is_space(ch)) break;
+
+		else if(ch == '\'' || ch == '"') quote = ch;
+
+		/* A backslash escapes any character, and a backslash before a
+		 * newline joins the two lines together. */
+		else if(ch == '\\' && read < end) {
+			if(*read != '\n') *write++ = *read;
+			read++;
+		}
+
+		else *write++ = ch;
+	}
+
+	/* An unterminated quote just runs to the end of the buffer. We always
+	 * have room for the null byte: either we stopped on the whitespace
+	 * after the token, or the caller left a byte spare at the end. */
+	*write = 0;
+	*cursor = read;
+	return token;
+}
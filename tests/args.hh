@@ -0,0 +1,37 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+/* Helpers shared by the C++ test programs. */
+
+/* Begin Header Guard */
+#ifndef LC_TESTS_ARGS_HH
+#define LC_TESTS_ARGS_HH 1
+
+#include <string>
+#include <vector>
+
+/* Build a writable argv out of some strings. */
+struct args_t {
+	args_t(std::vector<std::string> strings): strings{strings} {
+		for(auto& string: this -> strings) argv.push_back(&string[0]);
+	}
+
+	std::vector<std::string> strings;
+	std::vector<char *> argv;
+};
+
+/* End Header Guard */
+#endif
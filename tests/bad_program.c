@@ -16,8 +16,8 @@
 
 #include <assert.h>
 
-#define LC_REQ_VER 1
-#define LC_REQ_SUBVER 0
+#define LC_REQ_VER 2
+#define LC_REQ_SUBVER 3
 
 #include <libClame.h>
 
@@ -27,16 +27,35 @@ int dummy_var = 0;
 LC_flag_t flags_1[] = {
 	/* The variables are: long_flag, short_flag, function, var_ptr,
 	 * var_type, value, fmt_string, arr_length, var_length, min_arr_length,
-	 * max_arr_length, readonly. */
+	 * max_arr_length, readonly, context, separator,
+	 * independent, reserve. */
 
 	/* --try / -t INT: This flag is wrong, as -1 isn't a valid var_type. */
-	{"try", 't', NULL, &dummy_var, -1, 0, "%d", NULL, 0, 0, 0, 0}
+	{"try", 't', NULL, &dummy_var, -1, 0, "%d", NULL, 0, 0, 0, 0, NULL, 0,
+		false, NULL}
 };
 
 LC_flag_t flags_2[] = {
 	/* --try / -t INT: This flag is incorrect because the format string is
 	 * a NULL string. */
-	{"try", 't', NULL, &dummy_var, LC_OTHER_VAR, 0, NULL, NULL, 0, 0, 0, 0}
+	{"try", 't', NULL, &dummy_var, LC_OTHER_VAR, 0, NULL, NULL, 0, 0, 0, 0,
+		NULL, 0, false, NULL}
+};
+
+LC_flag_t flags_3[] = {
+	/* --try / -t and --try / -T: The long flag is defined twice. */
+	{"try", 't', NULL, NULL, 0, 0, NULL, NULL, 0, 0, 0, 0,
+		NULL, 0, false, NULL},
+	{"try", 'T', NULL, NULL, 0, 0, NULL, NULL, 0, 0, 0, 0,
+		NULL, 0, false, NULL}
+};
+
+LC_flag_t flags_4[] = {
+	/* --try / -t and --test / -t: The short flag is defined twice. */
+	{"try", 't', NULL, NULL, 0, 0, NULL, NULL, 0, 0, 0, 0,
+		NULL, 0, false, NULL},
+	{"test", 't', NULL, NULL, 0, 0, NULL, NULL, 0, 0, 0, 0,
+		NULL, 0, false, NULL}
 };
 
 int main(int argc, char **argv) {
@@ -55,6 +74,15 @@ int main(int argc, char **argv) {
 	LC_flags_length = LC_ARRAY_LENGTH(flags_2);
 	assert(LC_read(argc, argv) == LC_NULL_FORMAT_STR);
 
+	/* Duplicate flag names should be caught when the flags are indexed. */
+	LC_flags = flags_3;
+	LC_flags_length = LC_ARRAY_LENGTH(flags_3);
+	assert(LC_read(argc, argv) == LC_DUP_FLAG);
+
+	LC_flags = flags_4;
+	LC_flags_length = LC_ARRAY_LENGTH(flags_4);
+	assert(LC_read(argc, argv) == LC_DUP_FLAG);
+
 	/* Return successfully. */
 	return 0;
 }
@@ -0,0 +1,107 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <cassert>
+#include <string>
+#include <vector>
+
+#define LC_REQ_VER 2
+#define LC_REQ_SUBVER 3
+
+#include <libClame/schema.hh>
+
+#include "args.hh"
+
+using namespace libClame;
+
+/* The variables should never be touched by events(). */
+bool boolean_var;
+std::string string_var;
+std::vector<int> int_arr;
+
+schema<
+	flag<"boolean_var", 'b', bool>,
+	flag<"string_var", 's', std::string>,
+	flag<"int_arr", 'i', std::vector<int>, 1>
+> flags(boolean_var, string_var, int_arr);
+
+/* Describe each event as a single string. */
+std::vector<std::string> describe(args_t& args) {
+	std::vector<std::string> ret;
+
+	for(auto ev: events(args.argv.size(), args.argv.data(), flags)) {
+		const char *kinds[] = {"flag", "value", "positional"};
+
+		ret.push_back(std::string(kinds[(int) ev.kind]) + " "
+			+ std::to_string(ev.index) + " " + std::string(ev.text)
+		);
+	}
+
+	return ret;
+}
+
+int main() {
+	args_t args_1{{
+		"events", "-bshello", "file", "--int_arr", "1", "2", "x", "--",
+		"-b"
+	}};
+
+	std::vector<std::string> events_1 = {
+		"flag 0 b", "flag 1 s", "value 1 hello", "positional 3 file",
+		"flag 2 int_arr", "value 2 1", "value 2 2", "positional 3 x",
+		"positional 3 -b"
+	};
+
+	assert(describe(args_1) == events_1);
+	assert(!boolean_var && string_var.empty() && int_arr.empty());
+
+	/* Values given with an `=' point into the argument. */
+	args_t args_2{{"events", "--string_var=a=b", "-i3"}};
+
+	std::vector<std::string> events_2 = {
+		"flag 1 string_var", "value 1 a=b", "flag 2 i", "value 2 3"
+	};
+
+	assert(describe(args_2) == events_2);
+
+	/* Nothing past the point where we stop is ever looked at, so the
+	 * error at the end doesn't come up. */
+	args_t args_3{{"events", "-b", "-b"}};
+
+	for(auto ev: events(3, args_3.argv.data(), flags)) {
+		assert(ev.kind == event_kind::flag && ev.index == 0);
+		break;
+	}
+
+	/* But errors come out of the loop when we get to them. */
+	int error = LC_OK;
+
+	try { describe(args_3); }
+	catch(libClame::exception& e) { error = e.error; }
+
+	assert(error == LC_VAR_RESET);
+
+	args_t args_4{{"events", "-i", "x"}};
+	error = LC_OK;
+
+	try { describe(args_4); }
+	catch(libClame::exception& e) { error = e.error; }
+
+	assert(error == LC_LESS_VALS);
+
+	/* Return successfully. */
+	return 0;
+}
@@ -0,0 +1,573 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+/* We need pipe(), fileno() and friends, which aren't part of C99. */
+#define _DEFAULT_SOURCE 1
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unistd.h>
+
+#define LC_REQ_VER 2
+#define LC_REQ_SUBVER 3
+
+#include <libClame.h>
+#include <LC_macros.h>
+
+/* The flags are shared between all the parsers. */
+bool boolean_var;
+char *string_var;
+
+LC_flag_t flags[] = {
+	LC_MAKE_BOOL("boolean_var", 'b', boolean_var, true),
+	LC_MAKE_STRING("string_var", 's', string_var)
+};
+
+/* An array flag for the allocator and feeding tests. */
+int *int_arr = NULL;
+size_t int_arr_length = 0;
+
+LC_flag_t arr_flags[] = {
+	LC_MAKE_BOOL("boolean_var", 'b', boolean_var, true),
+	LC_MAKE_STRING("string_var", 's', string_var),
+	LC_MAKE_ARR("int_arr", 'i', int_arr, "%d", int_arr_length)
+};
+
+/* Array flags whose values are split up on a separator. */
+int *ids = NULL;
+double *vals = NULL;
+char **names = NULL;
+size_t ids_length = 0, vals_length = 0, names_length = 0;
+
+LC_flag_t list_flags[] = {
+	LC_MAKE_ARR_SEP("ids", 'i', ids, "%d", ids_length, ','),
+	LC_MAKE_ARR_SEP("vals", 'v', vals, "%lf", vals_length, ':'),
+	LC_MAKE_STRING_ARR_SEP("names", 'n', names, names_length, ',')
+};
+
+/* Callback functions that can be deferred to the end of the parse. The ones
+ * that run in order write down their short flags as they go. */
+char calls[8];
+size_t calls_length = 0;
+
+static int record(LC_flag_t *flag) {
+	calls[calls_length++] = flag -> short_flag;
+
+	/* The variables set after this flag on the command line are already
+	 * set by the time it runs. */
+	return boolean_var? LC_FUNCTION_OK: LC_FUNCTION_ERR;
+}
+
+static int fail(LC_flag_t *flag) {
+	return flag -> short_flag;
+}
+
+static int count_call(LC_flag_t *flag) {
+	(*(int *) flag -> context)++;
+	return LC_FUNCTION_OK;
+}
+
+LC_flag_t call_flags[] = {
+	LC_MAKE_CALL("early", 'e', record),
+	LC_MAKE_BOOL("boolean_var", 'b', boolean_var, true),
+	LC_MAKE_CALL("late", 'l', record),
+	LC_MAKE_CALL("fail", 'x', fail),
+	LC_MAKE_CALL("fail_again", 'y', fail),
+	LC_MAKE_CALL("open", 'o', count_call)
+};
+
+/* Argument lists to parse. */
+char *args_1[] = {"parser", "-b", "hello", "-s", "world"};
+char *args_2[] = {"parser", "-bb"};
+char *args_3[] = {"parser", "-i", "1", "2", "3", "--", "file"};
+
+/* Long enough that the `=' and the end are in different 16-byte blocks. */
+char lflag[] = "--string_var=hello, world=again";
+char *args_5[] = {"parser", lflag, "-", "--", "-b", ""};
+
+/* Enough values to be converted on several threads with a low threshold. */
+char *args_8[] = {"parser", "-i", "1", "2", "3", "4", "5", "6", "7", "8", "9",
+	"10", "x", "11", "--", "12"};
+
+/* Callback functions out of order, two of which fail. */
+char *args_10[] = {"parser", "-l", "-y", "-o", "-e", "-x", "-b"};
+
+/* Long flags and string arrays get split up in place, so these have to be
+ * writable. */
+char ids_arg[] = "--ids=1,2,3", names_arg[] = "--names=a,,b";
+char bad_ids_arg[] = "--ids=1,2,";
+
+char *args_6[] = {"parser", ids_arg, "4,5", "6", "1,x", "--vals", "0.5:-2",
+	"--", names_arg, "c"};
+
+char *args_7[] = {"parser", bad_ids_arg};
+
+/* Command line to split up in place. */
+char line[] = "parser\t-s 'hello world'  \"a b\" c\\ d ";
+
+/* Arguments to stream in, the way `find -print0' would write them. */
+const char stream[] = "-s\0hello\0a b\0\0c";
+
+/* Allocator that counts how many times it gets called. */
+static void *count_realloc(void *context, void *ptr, size_t size) {
+	(*(size_t *) context)++;
+	return realloc(ptr, size);
+}
+
+static void count_free(void *context, void *ptr) {
+	(void) context;
+	free(ptr);
+}
+
+/* Count the flagless arguments instead of keeping them. */
+static int count_arg(void *context, char *arg) {
+	if(!strcmp(arg, "stop")) return LC_FUNCTION_ERR;
+
+	(*(size_t *) context)++;
+	return LC_FUNCTION_OK;
+}
+
+int main() {
+	LC_parser_t parser_1, parser_2;
+
+	assert(LC_parser_init(&parser_1, flags, LC_ARRAY_LENGTH(flags))
+		== LC_OK);
+
+	assert(LC_parser_init(&parser_2, flags, LC_ARRAY_LENGTH(flags))
+		== LC_OK);
+
+	/* A parser can be used as many times as we like, since the flags it
+	 * has seen are kept in the parser rather than the flags. */
+	for(int i = 0; i < 2; i++) {
+		assert(LC_parse(&parser_1, LC_ARRAY_LENGTH(args_1), args_1)
+			== LC_OK);
+
+		assert(boolean_var && !strcmp(string_var, "world"));
+		assert(parser_1.flagless_args_length == 1);
+		assert(!strcmp(parser_1.flagless_args[0], "hello"));
+		assert(!flags[0].readonly && !flags[1].readonly);
+	}
+
+	/* Errors in one parser don't affect the other. */
+	assert(LC_parse(&parser_2, LC_ARRAY_LENGTH(args_2), args_2)
+		== LC_VAR_RESET);
+
+	/* And they say where the parse stopped. */
+	assert(parser_2.err_index == 1 && parser_2.err_flag == &flags[0]);
+
+	assert(parser_1.flagless_args_length == 1);
+	assert(!strcmp(parser_1.prog_name, "parser"));
+
+	/* Only the first `=' splits off the value, and nothing after the `--'
+	 * is a flag. */
+	assert(LC_parse(&parser_1, LC_ARRAY_LENGTH(args_5), args_5) == LC_OK);
+	assert(!strcmp(string_var, "hello, world=again"));
+
+	assert(parser_1.flagless_args_length == 3);
+	assert(!strcmp(parser_1.flagless_args[0], "-"));
+	assert(!strcmp(parser_1.flagless_args[1], "-b"));
+	assert(!strcmp(parser_1.flagless_args[2], ""));
+
+	/* Strings get split up the same way the shell would, and the values
+	 * point straight into them. */
+	assert(LC_parse_string(&parser_2, line) == LC_OK);
+
+	assert(!strcmp(string_var, "hello world"));
+	assert(string_var > line && string_var < line + sizeof(line));
+
+	assert(parser_2.flagless_args_length == 2);
+	assert(!strcmp(parser_2.flagless_args[0], "a b"));
+	assert(!strcmp(parser_2.flagless_args[1], "c d"));
+	assert(!strcmp(parser_2.prog_name, "parser"));
+
+	char empty[] = " ";
+	assert(LC_parse_string(&parser_2, empty) == LC_OK);
+	assert(!parser_2.prog_name && !parser_2.flagless_args_length);
+
+	LC_parser_free(&parser_1);
+	LC_parser_free(&parser_2);
+
+	/* Everything from a parse can come from an arena, and releasing the
+	 * parse resets the variables and the arena together. */
+	LC_arena_t arena;
+	LC_arena_init(&arena, 0);
+
+	LC_allocator_t allocator = LC_arena_allocator(&arena);
+	LC_parser_t parser_3;
+
+	assert(LC_parser_init(&parser_3, arr_flags, LC_ARRAY_LENGTH(arr_flags))
+		== LC_OK);
+
+	LC_parser_set_allocator(&parser_3, &allocator);
+
+	for(int i = 0; i < 2; i++) {
+		assert(LC_parse(&parser_3, LC_ARRAY_LENGTH(args_3), args_3)
+			== LC_OK);
+
+		assert(int_arr_length == 3 && int_arr[0] == 1);
+		assert(int_arr[1] == 2 && int_arr[2] == 3);
+		assert(parser_3.flagless_args_length == 1);
+		assert(arena.blocks);
+
+		LC_parser_release(&parser_3);
+		assert(!int_arr && !int_arr_length);
+		assert(!parser_3.flagless_args);
+	}
+
+	LC_parser_free(&parser_3);
+	LC_arena_free(&arena);
+	assert(!arena.blocks);
+
+	/* Parsing into the same arrays again reuses all of their room, so a
+	 * parser that has seen a command line doesn't go back to the
+	 * allocator for another one like it. */
+	size_t alloc_calls = 0;
+	allocator = (LC_allocator_t) {
+		count_realloc, count_free, NULL, &alloc_calls
+	};
+
+	assert(LC_parser_init(&parser_3, arr_flags, LC_ARRAY_LENGTH(arr_flags))
+		== LC_OK);
+
+	LC_parser_set_allocator(&parser_3, &allocator);
+
+	for(int i = 0; i < 3; i++) {
+		alloc_calls = 0;
+
+		assert(LC_parse(&parser_3, LC_ARRAY_LENGTH(args_3), args_3)
+			== LC_OK);
+
+		assert(int_arr_length == 3 && int_arr[2] == 3);
+		assert(i? !alloc_calls: alloc_calls);
+	}
+
+	LC_parser_release(&parser_3);
+
+	/* Moving on to different flags leaves the arrays in the old flags'
+	 * variables to us, so releasing the parser afterwards doesn't touch
+	 * them. */
+	assert(LC_parse(&parser_3, LC_ARRAY_LENGTH(args_3), args_3) == LC_OK);
+	int *old_arr = int_arr;
+
+	parser_3.flags = flags;
+	parser_3.flags_length = LC_ARRAY_LENGTH(flags);
+
+	assert(LC_parse(&parser_3, LC_ARRAY_LENGTH(args_1), args_1) == LC_OK);
+	LC_parser_release(&parser_3);
+
+	assert(int_arr == old_arr && int_arr_length == 3);
+	free(int_arr);
+	int_arr = NULL;
+	int_arr_length = 0;
+
+	LC_parser_free(&parser_3);
+
+	/* Arguments can be fed in one at a time, and each flag is evaluated
+	 * as soon as all of its values are there. */
+	LC_parser_t parser_4;
+
+	assert(LC_parser_init(&parser_4, arr_flags, LC_ARRAY_LENGTH(arr_flags))
+		== LC_OK);
+
+	boolean_var = false;
+	string_var = NULL;
+
+	assert(LC_feed(&parser_4, "parser") == LC_OK);
+	assert(LC_feed(&parser_4, "-s") == LC_OK && !string_var);
+	assert(LC_feed(&parser_4, "hello") == LC_OK);
+	assert(!strcmp(string_var, "hello"));
+
+	/* An array of numbers ends at the first value that isn't one. */
+	char *args_4[] = {"-i", "1", "2"};
+	assert(LC_feed_args(&parser_4, 3, args_4) == LC_OK);
+	assert(!int_arr_length);
+
+	assert(LC_feed(&parser_4, "file") == LC_OK);
+	assert(int_arr_length == 2 && int_arr[1] == 2);
+	assert(parser_4.flagless_args_length == 1);
+
+	assert(LC_feed(&parser_4, "-b") == LC_OK && boolean_var);
+	assert(LC_feed(&parser_4, "--") == LC_OK);
+	assert(LC_feed(&parser_4, "-x") == LC_OK);
+	assert(LC_finish(&parser_4) == LC_OK);
+
+	assert(parser_4.flagless_args_length == 2);
+	assert(!strcmp(parser_4.flagless_args[1], "-x"));
+
+	/* A flag still waiting on its value when we finish is an error. */
+	assert(LC_feed(&parser_4, "parser") == LC_OK);
+	assert(LC_feed(&parser_4, "-b") == LC_OK);
+	assert(LC_feed(&parser_4, "-s") == LC_OK);
+	assert(LC_finish(&parser_4) == LC_NO_VAL);
+
+	/* The index counts everything fed in, not just what's pending. */
+	assert(parser_4.err_index == 2);
+	assert(parser_4.err_flag == &arr_flags[1]);
+
+	LC_parser_release(&parser_4);
+	LC_parser_free(&parser_4);
+	assert(!int_arr);
+
+	/* Arguments can be read straight from a pipe. The last one doesn't
+	 * need a delimiter, and empty ones are kept. */
+	LC_parser_t parser_5;
+
+	assert(LC_parser_init(&parser_5, flags, LC_ARRAY_LENGTH(flags))
+		== LC_OK);
+
+	int fds[2];
+	assert(pipe(fds) == 0);
+	assert(write(fds[1], stream, sizeof(stream) - 1)
+		== sizeof(stream) - 1);
+	close(fds[1]);
+
+	assert(LC_parse_fd(&parser_5, "parser", fds[0], 0) == LC_OK);
+	close(fds[0]);
+
+	assert(!strcmp(string_var, "hello"));
+	assert(parser_5.flagless_args_length == 3);
+	assert(!strcmp(parser_5.flagless_args[0], "a b"));
+	assert(!strcmp(parser_5.flagless_args[1], ""));
+	assert(!strcmp(parser_5.flagless_args[2], "c"));
+	assert(!strcmp(parser_5.prog_name, "parser"));
+
+	/* Regular files are mapped in, unless some of the file has already
+	 * been read, and a big file gets read over several blocks. */
+	FILE *file = tmpfile();
+	assert(file);
+
+	fputs("-b\n", file);
+	for(int i = 0; i < 100000; i++) fputs("arg\n", file);
+	fputs("-s\nworld", file);
+	fflush(file);
+
+	size_t count = 0;
+	parser_5.flagless_function = count_arg;
+	parser_5.flagless_context = &count;
+
+	for(int i = 0; i < 2; i++) {
+		boolean_var = false;
+		lseek(fileno(file), i * 3, SEEK_SET);
+
+		assert(LC_parse_fd(&parser_5, "parser", fileno(file), '\n')
+			== LC_OK);
+
+		assert(boolean_var == !i && !strcmp(string_var, "world"));
+		assert(count == 100000 && !parser_5.flagless_args_length);
+		count = 0;
+	}
+
+	/* The function can stop the parse partway through. */
+	fputs("\nstop\n", file);
+	fflush(file);
+	rewind(file);
+
+	assert(LC_parse_fd(&parser_5, "parser", fileno(file), '\n')
+		== LC_FUNC_ERR);
+
+	assert(!parser_5.err_function && parser_5.function_errno);
+	fclose(file);
+
+	/* An fd that can't be read from gives up just after the program name,
+	 * rather than leaving the last parse's error where it was. */
+	assert(LC_parse(&parser_5, LC_ARRAY_LENGTH(args_2), args_2)
+		== LC_VAR_RESET);
+
+	assert(parser_5.err_flag == &flags[0]);
+	assert(LC_parse_fd(&parser_5, "parser", -1, '\n') == LC_READ_ERR);
+	assert(parser_5.err_index == 1 && !parser_5.err_flag);
+
+	LC_parser_free(&parser_5);
+
+	/* Lists of values can be given in one argument or spread over several,
+	 * and an argument that isn't a valid list ends the array. */
+	LC_parser_t parser_6;
+
+	assert(LC_parser_init(&parser_6, list_flags,
+		LC_ARRAY_LENGTH(list_flags)) == LC_OK);
+
+	assert(LC_parse(&parser_6, LC_ARRAY_LENGTH(args_6), args_6) == LC_OK);
+
+	assert(ids_length == 6);
+	for(int i = 0; i < 6; i++) assert(ids[i] == i + 1);
+
+	assert(vals_length == 2 && vals[0] == 0.5 && vals[1] == -2);
+
+	assert(names_length == 4 && !strcmp(names[0], "a"));
+	assert(!strcmp(names[1], "") && !strcmp(names[2], "b"));
+	assert(!strcmp(names[3], "c"));
+
+	assert(parser_6.flagless_args_length == 1);
+	assert(!strcmp(parser_6.flagless_args[0], "1,x"));
+
+	/* An empty element makes the whole value invalid. */
+	assert(LC_parse(&parser_6, LC_ARRAY_LENGTH(args_7), args_7)
+		== LC_BAD_VAL);
+
+	assert(parser_6.err_index == 1 && parser_6.err_flag == &list_flags[0]);
+
+	LC_parser_free(&parser_6);
+
+	/* Converting on several threads gives exactly the same results. */
+	LC_parser_t parser_7;
+
+	assert(LC_parser_init(&parser_7, arr_flags, LC_ARRAY_LENGTH(arr_flags))
+		== LC_OK);
+
+	parser_7.convert_threads = 3;
+	parser_7.convert_threshold = 3;
+
+	assert(LC_parse(&parser_7, LC_ARRAY_LENGTH(args_8), args_8) == LC_OK);
+
+	assert(int_arr_length == 10);
+	for(int i = 0; i < 10; i++) assert(int_arr[i] == i + 1);
+
+	assert(parser_7.flagless_args_length == 3);
+	assert(!strcmp(parser_7.flagless_args[0], "x"));
+	assert(!strcmp(parser_7.flagless_args[1], "11"));
+	assert(!strcmp(parser_7.flagless_args[2], "12"));
+
+	/* The `--' after the values still ends the array. */
+	assert(LC_parse(&parser_7, LC_ARRAY_LENGTH(args_3), args_3) == LC_OK);
+	assert(int_arr_length == 3 && int_arr[2] == 3);
+	assert(parser_7.flagless_args_length == 1);
+
+	LC_parser_release(&parser_7);
+	LC_parser_free(&parser_7);
+	assert(!int_arr);
+
+	/* A huge command line can be looked up on several threads first. The
+	 * flags are still evaluated in order, so a flag can still be the value
+	 * of the flag before it. */
+	static char *args_9[100000];
+	static char string_arg[] = "--string_var=hello";
+	static char bad_arg[] = "--nope";
+
+	args_9[0] = "parser";
+	for(size_t i = 1; i < 99990; i++) args_9[i] = "arg";
+
+	char *tail[] = {"-s", "--boolean_var", string_arg, "-i", "1", "2", "--",
+		"--", "-b", "last"};
+
+	memcpy(&args_9[99990], tail, sizeof(tail));
+
+	LC_parser_t parser_8;
+
+	assert(LC_parser_init(&parser_8, arr_flags, LC_ARRAY_LENGTH(arr_flags))
+		== LC_OK);
+
+	parser_8.parse_threads = 4;
+	boolean_var = false;
+
+	assert(LC_parse(&parser_8, 99992, args_9) == LC_OK);
+	assert(!boolean_var && !strcmp(string_var, "--boolean_var"));
+	assert(parser_8.flagless_args_length == 99989);
+
+	assert(LC_parse(&parser_8, 100000, args_9) == LC_VAR_RESET);
+
+	args_9[99990] = string_arg;
+	args_9[99991] = "-b";
+	args_9[99992] = "arg";
+	string_arg[12] = '='; // Put back what the last parse took out.
+
+	assert(LC_parse(&parser_8, 100000, args_9) == LC_OK);
+	assert(boolean_var && !strcmp(string_var, "hello"));
+	assert(int_arr_length == 2 && int_arr[1] == 2);
+	assert(parser_8.flagless_args_length == 99989 + 3);
+
+	args_9[50000] = bad_arg;
+	assert(LC_parse(&parser_8, 100000, args_9) == LC_BAD_FLAG);
+
+	/* On one thread, the arguments are looked up a few at a time, and a
+	 * flag's values can run on past the ones that were looked up. */
+	parser_8.parse_threads = 0;
+	boolean_var = false;
+
+	args_9[1] = "-i";
+	for(size_t i = 2; i < 1000; i++) args_9[i] = "7";
+	args_9[1000] = "--boolean_var";
+
+	assert(LC_parse(&parser_8, 1001, args_9) == LC_OK);
+	assert(int_arr_length == 998 && boolean_var);
+
+	LC_parser_release(&parser_8);
+	LC_parser_free(&parser_8);
+
+	/* Deferred callback functions run in the order of the command line
+	 * once the parse is over, and all of their errors are kept. */
+	int opened = 0;
+	call_flags[5].context = &opened;
+	call_flags[5].independent = true;
+
+	LC_parser_t parser_9;
+
+	assert(LC_parser_init(&parser_9, call_flags,
+		LC_ARRAY_LENGTH(call_flags)) == LC_OK);
+
+	parser_9.defer_functions = true;
+
+	for(size_t threads = 0; threads <= 4; threads += 4) {
+		parser_9.function_threads = threads;
+		boolean_var = false;
+		calls_length = 0;
+		opened = 0;
+
+		assert(LC_parse(&parser_9, LC_ARRAY_LENGTH(args_10), args_10)
+			== LC_FUNC_ERR);
+
+		/* args_10 gives -l before -e and -y before -x, the other way
+		 * round from the flags array, and that's the order they run
+		 * and fail in. */
+		assert(calls_length == 2 && !memcmp(calls, "le", 2));
+		assert(opened == 1);
+
+		assert(parser_9.function_errors_length == 2);
+		assert(parser_9.function_errors[0].flag == &call_flags[4]);
+		assert(parser_9.function_errors[0].function_errno == 'y');
+		assert(parser_9.function_errors[1].flag == &call_flags[3]);
+
+		assert(parser_9.err_function == fail);
+		assert(parser_9.function_errno == 'y');
+
+		/* The callback functions come after all the arguments. */
+		assert(parser_9.err_index == LC_ARRAY_LENGTH(args_10));
+		assert(parser_9.err_flag == &call_flags[4]);
+	}
+
+	LC_parser_free(&parser_9);
+
+	/* LC_read() still marks the flags as read-only, so the same flags
+	 * can't be set by a second call. */
+	LC_flags = flags;
+	LC_flags_length = LC_ARRAY_LENGTH(flags);
+
+	assert(LC_read(LC_ARRAY_LENGTH(args_1), args_1) == LC_OK);
+	assert(LC_flagless_args_length == 1);
+	assert(flags[0].readonly && flags[1].readonly);
+
+	assert(LC_read(LC_ARRAY_LENGTH(args_1), args_1) == LC_VAR_RESET);
+	assert(LC_err_index == 1 && LC_err_flag == &flags[0]);
+
+	/* LC_free() lets go of the flagless arguments. */
+	LC_free();
+	assert(!LC_flagless_args && !LC_flagless_args_length);
+
+	/* Return successfully. */
+	return 0;
+}
@@ -16,8 +16,8 @@
 
 #include <stdio.h>
 
-#define LC_REQ_VER 1
-#define LC_REQ_SUBVER 1
+#define LC_REQ_VER 2
+#define LC_REQ_SUBVER 3
 
 #include <libClame.h>
 #include <LC_macros.h>
@@ -29,6 +29,12 @@ int custom_callback(LC_flag_t *flag) {
 	return LC_OK;
 }
 
+/* Function that prints the context of its flag. */
+int context_callback(LC_flag_t *flag) {
+	printf("%s(); ", (char *) flag -> context);
+	return LC_OK;
+}
+
 /* We're going to stress-test every data type we can think of. */
 bool boolean_var;
 char *string_var, **string_arr; size_t string_arr_len;
@@ -48,6 +54,11 @@ int *limited_arr; size_t limited_arr_len; // Arr of only two values.
 
 LC_flag_t args[] = {
 	LC_MAKE_CALL("callback", 'c', custom_callback),
+	LC_MAKE_CALL("long_callback", 0, custom_callback), // No short flag.
+
+	{.short_flag = 'C', .function = context_callback, // No long flag.
+		.context = "context_callback"},
+
 	LC_MAKE_BOOL("boolean_var", 'b', boolean_var, true),
 
 	LC_MAKE_BOOL_F(
@@ -90,6 +101,9 @@ int main(int argc, char **argv) {
 	LC_flags_length = LC_ARRAY_LENGTH(args);
 	LC_flags = args;
 
+	/* Allow a few levels of response files. */
+	LC_response_depth = 4;
+
 	int ret = LC_read(argc, argv);
 
 	switch(ret) {
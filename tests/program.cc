@@ -17,8 +17,8 @@
 #include <iomanip>
 #include <iostream>
 
-#define LC_REQ_VER 1
-#define LC_REQ_SUBVER 2
+#define LC_REQ_VER 2
+#define LC_REQ_SUBVER 3
 
 #include <libClame.hh>
 #include <libClame/generics.hh>
@@ -97,6 +97,12 @@ void print_numeric(
 int main(int argc, char **argv) {
 	/* Set up our flags. */
 	flags.push_back(make_call("callback", 'c', custom_callback));
+	flags.push_back(make_call("long_callback", 0, custom_callback));
+
+	flags.push_back(make_call("", 'C', [](){ // No long flag.
+		std::cout << "context_callback(); ";
+	}));
+
 	flags.push_back(make_bool("boolean_var", 'b', boolean_var, true));
 
 	flags.push_back(make_bool(
@@ -136,6 +142,9 @@ int main(int argc, char **argv) {
 		custom_callback
 	));
 
+	/* Allow a few levels of response files. */
+	LC_response_depth = 4;
+
 	try {
 		libClame::read(argc, argv, flags);
 	}
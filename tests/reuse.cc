@@ -0,0 +1,268 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <array>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define LC_REQ_VER 2
+#define LC_REQ_SUBVER 3
+
+#include <libClame.hh>
+#include <libClame/generics.hh>
+
+#include "args.hh"
+
+using namespace libClame;
+
+/* Variables for the flags to set. */
+bool boolean_var;
+std::string string_var;
+std::vector<int> int_arr;
+
+/* Count the allocations made by the C code and the C++ code alike, on each
+ * thread separately. */
+thread_local size_t alloc_calls;
+
+void *operator new(size_t size) {
+	alloc_calls++;
+
+	void *ptr = malloc(size? size: 1);
+	if(!ptr) throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+static void *count_realloc(void *context, void *ptr, size_t size) {
+	(*(size_t *) context)++;
+	return realloc(ptr, size);
+}
+
+static void count_free(void *context, void *ptr) {
+	(void) context;
+	free(ptr);
+}
+
+/* Parse a command line with a parser, returning the error. */
+int parse(libClame::parser& parser, args_t args) {
+	try { parser.read(args.argv.size(), args.argv.data()); }
+	catch(libClame::exception& e) { return e.error; }
+
+	return LC_OK;
+}
+
+/* Add a flag to a parser, returning the error. */
+int add_error(libClame::parser& parser, LC_flag_t flag) {
+	try { parser.add(flag); }
+	catch(libClame::exception& e) { return e.error; }
+
+	return LC_OK;
+}
+
+int main() {
+	std::string lflag;
+	size_t entries;
+
+	{
+		libClame::parser parser;
+
+		parser.add(make_bool("boolean_var", 'b', boolean_var, true));
+		parser.add(make_string("string_var", 's', string_var));
+		parser.add(make_arr("int_arr", 'i', int_arr));
+
+		/* The strings for the flags are interned, so each distinct one
+		 * is only stored once. */
+		assert(__intern("%d") == __intern(std::string("%d")));
+		assert(__make_lflag(lflag = "int_arr") == __intern("int_arr"));
+
+		entries = __entries().size();
+
+		/* The same flags can be set by each command line in turn. */
+		args_t args_1{{"reuse", "-b", "-s", "hello", "file"}};
+		parser.read(args_1.argv.size(), args_1.argv.data());
+
+		assert(boolean_var && string_var == "hello");
+		assert(parser.flagless_args().size() == 1);
+		assert(!strcmp(parser.flagless_args()[0], "file"));
+		assert(!strcmp(parser.prog_name(), "reuse"));
+
+		args_t args_2{{"reuse", "--string_var=world", "-i", "1", "2"}};
+		parser.read(args_2.argv.size(), args_2.argv.data());
+
+		assert(string_var == "world");
+		assert(int_arr == std::vector<int>({1, 2}));
+		assert(parser.flagless_args().empty());
+
+		/* Errors still come up within a single command line. */
+		assert(parse(parser, {{"reuse", "-b", "-b"}}) == LC_VAR_RESET);
+		assert(parse(parser, {{"reuse", "-s"}}) == LC_NO_VAL);
+
+		/* try_read() hands them back instead of throwing them. */
+		args_t args_5{{"reuse", "-b", "-s"}};
+		auto ret = parser.try_read(
+			args_5.argv.size(), args_5.argv.data()
+		);
+
+		assert(!ret && ret.error().code == LC_NO_VAL);
+		assert(ret.error().index == 2);
+		assert(ret.error().flag -> short_flag == 's');
+		assert(!strcmp(ret.error().what(), "LC_NO_VAL"));
+
+		ret = parser.try_read(args_1.argv.size(), args_1.argv.data());
+		assert(ret && ret -> flagless_args.size() == 1);
+		assert(!strcmp(ret -> prog_name, "reuse"));
+
+		args_t args_3{{"reuse", "-i", "3", "--", "a", "b"}};
+		parser.read(args_3.argv.size(), args_3.argv.data());
+
+		assert(int_arr == std::vector<int>({3}));
+		assert(parser.flagless_args().size() == 2);
+
+		/* A bad value leaves the vector as it was. */
+		assert(parse(parser, {{"reuse", "--int_arr=x"}}) == LC_BAD_VAL);
+		assert(int_arr == std::vector<int>({3}));
+
+		parser.reset();
+		assert(parser.flagless_args().empty() && !parser.prog_name());
+
+		/* Once a parser has seen a command line, parsing another one
+		 * like it doesn't allocate anything. */
+		LC_allocator_t allocator = {
+			count_realloc, count_free, NULL, &alloc_calls
+		};
+
+		LC_parser_set_allocator(&parser.c_parser(), &allocator);
+
+		args_t args_7{{
+			"reuse", "-b", "-s", "a string too long for SSO", "-i",
+			"1", "2", "3", "--", "file"
+		}};
+
+		for(int i = 0; i < 5; i++) {
+			alloc_calls = 0;
+			parser.reset();
+			parser.read(args_7.argv.size(), args_7.argv.data());
+
+			assert(i? !alloc_calls: alloc_calls);
+			assert(int_arr == std::vector<int>({1, 2, 3}));
+			assert(parser.flagless_args().size() == 1);
+		}
+	}
+
+	/* Flags made for a parser that's gone don't get in the way of any
+	 * that are made afterwards, and reuse the entries it had. */
+	libClame::parser parser;
+	parser.add(make_bool("boolean_var", 'b', boolean_var, false));
+	assert(__entries().size() == entries);
+
+	args_t args_4{{"reuse", "--boolean_var"}};
+	parser.read(args_4.argv.size(), args_4.argv.data());
+	assert(!boolean_var);
+
+	/* A flag belongs to the first parser it's added to, so a second one
+	 * can't have it, and getting rid of that one leaves it alone. */
+	auto string_flag = make_string("string_var", 's', string_var);
+	auto first = std::make_unique<libClame::parser>();
+	auto second = std::make_unique<libClame::parser>();
+
+	first -> add(string_flag);
+	assert(add_error(*second, string_flag) == LC_DUP_FLAG);
+
+	second.reset();
+	make_bool("boolean_var", 'b', boolean_var, true);
+
+	args_t args_8{{"reuse", "-s", "first"}};
+	first -> read(args_8.argv.size(), args_8.argv.data());
+	assert(string_var == "first");
+
+	/* The flag goes with the parser, so a new one is needed after that. */
+	first.reset();
+	string_flag = make_string("string_var", 's', string_var);
+	assert(add_error(parser, string_flag) == LC_OK);
+
+	/* Parsers on different threads can make their flags at once, while
+	 * none of them can take one that's already been added elsewhere. */
+	std::vector<std::thread> threads;
+
+	for(int i = 0; i < 4; i++) threads.emplace_back([i, string_flag]{
+		std::vector<int> values(100);
+		libClame::parser parser;
+		assert(add_error(parser, string_flag) == LC_DUP_FLAG);
+
+		for(int j = 0; j < 100; j++) {
+			auto name = "flag_" + std::to_string(i * 100 + j);
+			parser.add(make_var(name, 0, values[j]));
+		}
+
+		auto flag = "--flag_" + std::to_string(i * 100 + 7);
+		args_t args{{"reuse", flag, "7"}};
+		parser.read(args.argv.size(), args.argv.data());
+		assert(values[7] == 7);
+	});
+
+	for(auto& thread: threads) thread.join();
+
+	args_t args_9{{"reuse", "-s", "still here"}};
+	parser.read(args_9.argv.size(), args_9.argv.data());
+	assert(string_var == "still here");
+
+	/* A std::function fits in a callback, and anything too big for one
+	 * goes on the heap instead. */
+	std::string calls;
+	std::array<char, 256> big{'b'};
+	std::function<void()> function = [&calls]{ calls += 'f'; };
+
+	libClame::parser callbacks;
+	callbacks.add(make_call("big", 0, [&calls, big]{ calls += big[0]; }));
+	callbacks.add(make_call("function", 0, function));
+
+	args_t args_10{{"reuse", "--big", "--function"}};
+	callbacks.read(args_10.argv.size(), args_10.argv.data());
+	assert(calls == "bf");
+
+	/* The globals can be used without exceptions too. */
+	std::vector<LC_flag_t> flags = {
+		make_string("string_var", 's', string_var)
+	};
+
+	args_t args_6{{"reuse", "-s", "again", "-x"}};
+	auto ret = try_read(args_6.argv.size(), args_6.argv.data(), flags);
+
+	assert(!ret && ret.error().code == LC_BAD_FLAG);
+	assert(ret.error().index == 3 && !ret.error().flag);
+
+	/* Flags that read() has used can't go to a parser, nor can flags that
+	 * a parser has go to read(). */
+	assert(add_error(parser, flags[0]) == LC_DUP_FLAG);
+
+	std::vector<LC_flag_t> parser_flags = {string_flag};
+	ret = try_read(args_6.argv.size(), args_6.argv.data(), parser_flags);
+
+	assert(!ret && ret.error().code == LC_DUP_FLAG);
+	assert(ret.error().flag == &parser_flags[0]);
+
+	/* Return successfully. */
+	return 0;
+}
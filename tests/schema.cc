@@ -0,0 +1,126 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+#define LC_REQ_VER 2
+#define LC_REQ_SUBVER 3
+
+#include <libClame/schema.hh>
+
+using namespace libClame;
+
+/* Function that prints when it's called. */
+void custom_callback() {
+	std::cout << "custom_callback(); ";
+}
+
+/* Variables of every kind a schema can set. */
+bool boolean_var, short_var;
+std::string string_var; std::string_view view_var;
+std::vector<std::string> string_arr;
+
+int int_var; std::vector<int> int_arr;
+double double_var; size_t size_var;
+uint8_t uint8_var; char char_var;
+
+std::vector<int> limited_arr; // Arr of only two values.
+
+/* The flags are checked when this is compiled. */
+schema<
+	flag<"callback", 'c', void>,
+	flag<"boolean_var", 'b', bool>,
+	flag<"", '#', bool>, // Short flag only.
+	flag<"string_var", 's', std::string>,
+	flag<"view_var", 0, std::string_view>, // Long flag only.
+	flag<"string_arr", 'S', std::vector<std::string>>,
+	flag<"int_var", 'i', int>,
+	flag<"int_arr", 'I', std::vector<int>>,
+	flag<"double_var", 'd', double>,
+	flag<"size_var", 'z', size_t>,
+	flag<"uint8_var", 'u', uint8_t>,
+	flag<"char_var", 'h', char>,
+	flag<"limited_arr", '2', std::vector<int>, 2, 2>
+> flags(
+	custom_callback, boolean_var, short_var, string_var, view_var,
+	string_arr, int_var, int_arr, double_var, size_var, uint8_var,
+	char_var, limited_arr
+);
+
+/* Helper to print arrays out. */
+template<typename T>
+void print_arr(const std::vector<T>& arr, const std::string& desc) {
+	if(!arr.size()) return;
+	std::cout << desc << "_arr = {";
+
+	for(const auto &i: arr) std::cout << i << ", ";
+	std::cout << "...}; ";
+}
+
+int main(int argc, char **argv) {
+	std::vector<char *> given(argv, argv + argc);
+
+	try {
+		flags.read(argc, argv);
+	}
+
+	catch(libClame::exception& e) {
+		return e.error;
+	}
+
+	/* The arguments are never moved around in argv. */
+	assert(std::equal(given.begin(), given.end(), argv));
+
+	/* Print all the values that were set. */
+	if(boolean_var) std::cout << "boolean_var = true; ";
+	if(short_var) std::cout << "short_var = true; ";
+
+	if(string_var != "") {
+		std::cout << "string_var = \"" << string_var << "\"; ";
+	}
+
+	if(view_var != "") {
+		std::cout << "view_var = \"" << view_var << "\"; ";
+	}
+
+	print_arr(string_arr, "string");
+
+	if(int_var) std::cout << "int_var = " << int_var << "; ";
+	print_arr(int_arr, "int");
+
+	if(double_var) std::cout << "double_var = " << double_var << "; ";
+	if(size_var) std::cout << "size_var = " << size_var << "; ";
+	if(uint8_var) std::cout << "uint8_var = " << (int) uint8_var << "; ";
+	if(char_var) std::cout << "char_var = '" << char_var << "'; ";
+
+	print_arr(limited_arr, "limited");
+
+	/* Print out the flagless arguments. */
+	if(flags.flagless_args().size()) {
+		std::cout << "flagless_args = {";
+		for(const auto &i: flags.flagless_args()) {
+			std::cout << "\"" << i << "\", ";
+		}
+		std::cout << "...}; ";
+	}
+
+	/* Return successfully. */
+	std::cout << "...";
+	return 0;
+}
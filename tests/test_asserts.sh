@@ -0,0 +1,38 @@
+#! /bin/bash
+
+# libClame: Command-line Arguments Made Easy
+# Copyright (C) 2021-2023 Jyothiraditya Nellakra
+#
+# This program is free software: you can redistribute it and/or modify it under
+# the terms of the GNU General Public License as published by the Free Software
+# Foundation, either version 3 of the License, or (at your option) any later
+# version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE. See the GNU General Public License for more 
+# details.
+#
+# You should have received a copy of the GNU General Public License along with
+# this program. If not, see <https://www.gnu.org/licenses/>.
+
+# Format to make some lines more visible than others.
+fmt="   \033[0;1m"
+
+# The test programs that check their own results with assert().
+programs="parser_test events_cc_test views_cc_test reuse_cc_test"
+
+if [ "$1" == "--valgrind" ] && command -v valgrind; then
+	runner="valgrind -q"
+else
+	runner=""
+fi
+
+for program in $programs; do
+	if (set -x; $runner build/$program); then
+		echo -e "$fmt-> All results were correct.\033[0;0m ✓\n"
+	else
+		echo -e "$fmt-> Incorrect results detected.\033[0;0m ✘\n"
+		exit 1
+	fi
+done
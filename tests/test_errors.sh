@@ -104,6 +104,18 @@ assert_eq "$?" "6"
 (set -x; $program --size_var "Five" > "/dev/null" 2>&1)
 assert_eq "$?" "6"
 
+(set -x; $program -z "-1" > "/dev/null" 2>&1)
+assert_eq "$?" "6"
+
+(set -x; $program -l "2147483648" > "/dev/null" 2>&1)
+assert_eq "$?" "6"
+
+(set -x; $program -o "400" > "/dev/null" 2>&1)
+assert_eq "$?" "6"
+
+(set -x; $program -x "100" > "/dev/null" 2>&1)
+assert_eq "$?" "6"
+
 (set -x; $program --size_arr "Five" > "/dev/null" 2>&1)
 assert_eq "$?" "0"
 
@@ -153,6 +165,12 @@ assert_eq "$?" "0"
 (set -x; $program --limited_arr "1" "2" "Three" > "/dev/null" 2>&1)
 assert_eq "$?" "0"
 
+#define LC_RESPONSE_ERR 13 // A response file couldn't be read or nests too deep.
+
+printf -- "-b @build/response_loop.txt" > build/response_loop.txt
+(set -x; $program @build/response_loop.txt > "/dev/null" 2>&1)
+assert_eq "$?" "13"
+
 }
 
 # Call the C and C++ test programs with various incorrect args to make sure the
@@ -43,6 +43,12 @@ test() {
 output=$(set -x; $program -c)
 assert_eq "$output" "custom_callback(); ..."
 
+output=$(set -x; $program --long_callback)
+assert_eq "$output" "custom_callback(); ..."
+
+output=$(set -x; $program -C)
+assert_eq "$output" "context_callback(); ..."
+
 # Try setting all the variables individually.
 
 output=$(set -x; $program -b)
@@ -93,6 +99,12 @@ assert_eq "$output" "int_arr = {123, 456, ...}; ..."
 output=$(set -x; $program --int_arr "123" "456")
 assert_eq "$output" "int_arr = {123, 456, ...}; ..."
 
+output=$(set -x; $program -l "-2147483648")
+assert_eq "$output" "int32_var = -2147483648; ..."
+
+output=$(set -x; $program -x "0xff")
+assert_eq "$output" "hex_var = ff; ..."
+
 output=$(set -x; $program -d"3.14")
 assert_eq "$output" "double_var = 3.14; ..."
 
@@ -265,6 +277,26 @@ assert_eq "$output" \
 "filename_arr = {\"filename\", ...}; \
 flagless_args = {\"--boolean_var\", ...}; ..."
 
+# Check response files, including nested ones.
+
+printf -- '-s "hello world"\n-I 1 2\n' > build/response_1.txt
+printf -- "-b @build/response_1.txt 'a b'" > build/response_2.txt
+
+output=$(set -x; $program @build/response_1.txt)
+assert_eq "$output" "string_var = \"hello world\"; int_arr = {1, 2, ...}; ..."
+
+output=$(set -x; $program @build/response_2.txt)
+assert_eq "$output" "boolean_var = true; string_var = \"hello world\"; \
+int_arr = {1, 2, ...}; flagless_args = {\"a b\", ...}; ..."
+
+printf -- '-s "\\$a \\`b\\` \\c"' > build/response_3.txt
+
+output=$(set -x; $program @build/response_3.txt)
+assert_eq "$output" "string_var = \"\$a \`b\` \\c\"; ..."
+
+output=$(set -x; $program @build/no_such_file)
+assert_eq "$output" "flagless_args = {\"@build/no_such_file\", ...}; ..."
+
 # Check multi-callback chaining.
 
 output=$(set -x; $program -c!@"123" "45")
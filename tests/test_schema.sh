@@ -0,0 +1,146 @@
+#! /bin/bash
+
+# libClame: Command-line Arguments Made Easy
+# Copyright (C) 2021-2023 Jyothiraditya Nellakra
+#
+# This program is free software: you can redistribute it and/or modify it under
+# the terms of the GNU General Public License as published by the Free Software
+# Foundation, either version 3 of the License, or (at your option) any later
+# version.
+#
+# This program is distributed in the hope that it will be useful, but WITHOUT
+# ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+# FOR A PARTICULAR PURPOSE. See the GNU General Public License for more 
+# details.
+
+# Format to make some lines more visible than others.
+fmt="   \033[0;1m"
+
+# Helper functions to report errors
+assert_eq() {
+	if [ "$?" -ne "0" ]; then
+		echo -e "$fmt-> Program crashed.\033[0;0m ✘\n"
+		exit 1
+	fi
+
+	if [ "$1" = "$2" ]; then
+		echo -e "$fmt-> Output correct.\033[0;0m ✓\n"
+	else
+		echo -e "$fmt->  Incorrect output (\"$1\" returned," \
+			"expected \"$2\").\033[0;0m ✘\n"
+		exit 1
+	fi
+}
+
+assert_ret() {
+	if [ "$1" -eq "$2" ]; then
+		echo -e "$fmt-> Return value correct.\033[0;0m ✓\n"
+	else
+		echo -e "$fmt->  Incorrect return value ($1 returned," \
+			"expected $2).\033[0;0m ✘\n"
+		exit 1
+	fi
+}
+
+# Helper function to test the schema executable
+test() {
+
+# Check each kind of flag.
+
+output=$(set -x; $program -c)
+assert_eq "$output" "custom_callback(); ..."
+
+output=$(set -x; $program -b#)
+assert_eq "$output" "boolean_var = true; short_var = true; ..."
+
+output=$(set -x; $program -s"testing")
+assert_eq "$output" "string_var = \"testing\"; ..."
+
+output=$(set -x; $program --string_var "testing")
+assert_eq "$output" "string_var = \"testing\"; ..."
+
+output=$(set -x; $program --view_var="testing")
+assert_eq "$output" "view_var = \"testing\"; ..."
+
+output=$(set -x; $program -S "hello" "world")
+assert_eq "$output" "string_arr = {hello, world, ...}; ..."
+
+output=$(set -x; $program -i "-12345")
+assert_eq "$output" "int_var = -12345; ..."
+
+output=$(set -x; $program --int_arr="123" "456" "seven")
+assert_eq "$output" \
+	"int_arr = {123, 456, ...}; flagless_args = {\"seven\", ...}; ..."
+
+output=$(set -x; $program -d "3.14")
+assert_eq "$output" "double_var = 3.14; ..."
+
+output=$(set -x; $program -z "+12345")
+assert_eq "$output" "size_var = 12345; ..."
+
+output=$(set -x; $program -u255 -hx)
+assert_eq "$output" "uint8_var = 255; char_var = 'x'; ..."
+
+output=$(set -x; $program -2 "123" "45")
+assert_eq "$output" "limited_arr = {123, 45, ...}; ..."
+
+# Check flagless arguments and the end of the flags.
+
+output=$(set -x; $program "hello" -b - -- -c)
+assert_eq "$output" \
+	"boolean_var = true; \
+flagless_args = {\"hello\", \"-\", \"-c\", ...}; ..."
+
+output=$(set -x; $program -bS "testing" -- -- -c)
+assert_eq "$output" \
+	"boolean_var = true; string_arr = {testing, ...}; \
+flagless_args = {\"-c\", ...}; ..."
+
+# Check the errors.
+
+(set -x; $program -? > "/dev/null" 2>&1)
+assert_ret "$?" "3"
+
+(set -x; $program --view_var= --unknown > "/dev/null" 2>&1)
+assert_ret "$?" "3"
+
+(set -x; $program -bb > "/dev/null" 2>&1)
+assert_ret "$?" "4"
+
+(set -x; $program --boolean_var -b > "/dev/null" 2>&1)
+assert_ret "$?" "4"
+
+(set -x; $program -s > "/dev/null" 2>&1)
+assert_ret "$?" "5"
+
+(set -x; $program --boolean_var=true > "/dev/null" 2>&1)
+assert_ret "$?" "6"
+
+(set -x; $program -z "-1" > "/dev/null" 2>&1)
+assert_ret "$?" "6"
+
+(set -x; $program -u "256" > "/dev/null" 2>&1)
+assert_ret "$?" "6"
+
+(set -x; $program -i "5Five" > "/dev/null" 2>&1)
+assert_ret "$?" "6"
+
+(set -x; $program -h "xy" > "/dev/null" 2>&1)
+assert_ret "$?" "6"
+
+(set -x; $program -2 "1" > "/dev/null" 2>&1)
+assert_ret "$?" "7"
+
+(set -x; $program -2 "1" "2" "3" > "/dev/null" 2>&1)
+assert_ret "$?" "8"
+
+}
+
+# Call the schema test program with various arguments.
+if [ "$1" == "--valgrind" ] && command -v valgrind; then
+	program="valgrind -q build/schema_cc_test"
+	test
+else
+	program="build/schema_cc_test"
+	test
+fi
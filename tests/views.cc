@@ -0,0 +1,78 @@
+/* libClame: Command-line Arguments Made Easy
+ * Copyright (C) 2021-2023 Jyothiraditya Nellakra
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even- the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>. */
+
+#include <cassert>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define LC_REQ_VER 2
+#define LC_REQ_SUBVER 3
+
+#include <libClame.hh>
+
+#include "args.hh"
+
+using namespace libClame;
+
+/* Views of the strings, which should point straight into argv. */
+std::string_view view_var;
+std::span<std::string_view> view_arr;
+
+std::vector<LC_flag_t> flags;
+
+int main() {
+	flags.push_back(make_string("view_var", 's', view_var));
+	flags.push_back(make_str_arr("view_arr", 'S', view_arr));
+
+	/* Leave the flagless arguments where they are. */
+	copy_args = false;
+
+	args_t args_1{{
+		"views", "--view_var=hello", "file", "-S", "a", "bc", "d"
+	}};
+
+	read(args_1.argv.size(), args_1.argv.data(), flags);
+
+	assert(view_var == "hello");
+	assert(view_var.data() == args_1.argv[1] + strlen("--view_var="));
+
+	assert(view_arr.size() == 3);
+	assert(view_arr[0] == "a" && view_arr[1] == "bc");
+	assert(view_arr[2] == "d");
+	assert(view_arr[1].data() == args_1.argv[5]);
+
+	assert(flagless_view().size() == 1);
+	assert(!strcmp(flagless_view()[0], "file"));
+	assert(flagless_view()[0] == args_1.argv[2]);
+
+	assert(flagless_args.empty() && prog_name.empty());
+
+	/* A later parse looks at its own arguments. The flags remember
+	 * being set, so they have to be cleared first. */
+	for(auto& flag: flags) flag.readonly = false;
+
+	args_t args_2{{"views", "-S", "e", "--", "-s", "f"}};
+	read(args_2.argv.size(), args_2.argv.data(), flags);
+
+	assert(view_arr.size() == 1 && view_arr[0] == "e");
+	assert(view_arr[0].data() == args_2.argv[2]);
+	assert(view_var == "f" && view_var.data() == args_2.argv[5]);
+	assert(flagless_view().empty());
+
+	/* Return successfully. */
+	return 0;
+}